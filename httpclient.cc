@@ -12,6 +12,7 @@ REQUIRES_SERVICE_PLACEHOLDER(log_builtins);
 REQUIRES_SERVICE_PLACEHOLDER(log_builtins_string);
 REQUIRES_SERVICE_PLACEHOLDER(dynamic_privilege_register);
 REQUIRES_SERVICE_PLACEHOLDER(udf_registration);
+REQUIRES_SERVICE_PLACEHOLDER(udf_registration_aggregate);
 REQUIRES_SERVICE_PLACEHOLDER(mysql_udf_metadata);
 REQUIRES_SERVICE_PLACEHOLDER(mysql_thd_security_context);
 REQUIRES_SERVICE_PLACEHOLDER(mysql_thd_store);
@@ -19,6 +20,15 @@ REQUIRES_SERVICE_PLACEHOLDER(global_grants_check);
 REQUIRES_SERVICE_PLACEHOLDER(mysql_current_thread_reader);
 REQUIRES_SERVICE_PLACEHOLDER(mysql_runtime_error);
 REQUIRES_SERVICE_PLACEHOLDER(status_variable_registration);
+REQUIRES_SERVICE_PLACEHOLDER(component_sys_variable_register);
+REQUIRES_SERVICE_PLACEHOLDER(component_sys_variable_unregister);
+REQUIRES_SERVICE_PLACEHOLDER(mysql_thd_attributes);
+REQUIRES_SERVICE_PLACEHOLDER(pfs_plugin_table_v1);
+REQUIRES_SERVICE_PLACEHOLDER(pfs_plugin_column_bigint_v1);
+REQUIRES_SERVICE_PLACEHOLDER(pfs_plugin_column_integer_v1);
+REQUIRES_SERVICE_PLACEHOLDER(pfs_plugin_column_string_v2);
+REQUIRES_SERVICE_PLACEHOLDER(pfs_plugin_column_timestamp_v2);
+REQUIRES_SERVICE_PLACEHOLDER(pfs_plugin_column_enum_v1);
 
 // declare log builtins to allow logging to error log
 SERVICE_TYPE(log_builtins) * log_bi;
@@ -27,178 +37,593 @@ SERVICE_TYPE(log_builtins_string) * log_bs;
 // define a custom privilege name required to call UDFs defined in this component
 static const char *HTTPCLIENT_PRIVILEGE_NAME = "HTTP_CLIENT";
 
+// number of shards of counters updated by all connection threads
+static const size_t counter_shards = 16;
+
+// return shard of current thread, threads are spread over shards round robin
+static size_t current_shard() {
+  static std::atomic<size_t> next_shard{0};
+  thread_local size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % counter_shards;
+  return shard;
+}
+
+// define a counter sharded over separate cache lines, so concurrent updates are neither lost nor contended
+class sharded_counter {
+  private:
+    struct alignas(64) shard {
+      std::atomic<unsigned long long> value{0};
+    };
+    shard shards[counter_shards];
+
+  public:
+    void add(unsigned long long value) {
+      shards[current_shard()].value.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    // aggregate all shards
+    unsigned long long load() const {
+      unsigned long long total = 0;
+      for (auto &s : shards) {
+        total += s.value.load(std::memory_order_relaxed);
+      }
+      return total;
+    }
+};
+
+// define a sharded histogram of durations in microseconds with log2 buckets
+class latency_histogram {
+  private:
+    static const size_t buckets = 40;
+
+    struct alignas(64) shard {
+      std::atomic<unsigned long long> counts[buckets]{};
+      std::atomic<unsigned long long> max{0};
+    };
+    shard shards[counter_shards];
+
+  public:
+    void record(unsigned long long duration_us) {
+      // bucket i holds durations of [2^i, 2^(i+1)) microseconds
+      size_t bucket = duration_us < 2 ? 0 : 63 - __builtin_clzll(duration_us);
+      if (bucket >= buckets) {
+        bucket = buckets - 1;
+      }
+
+      shard &s = shards[current_shard()];
+      s.counts[bucket].fetch_add(1, std::memory_order_relaxed);
+
+      auto max = s.max.load(std::memory_order_relaxed);
+      while (duration_us > max && !s.max.compare_exchange_weak(max, duration_us, std::memory_order_relaxed)) {
+      }
+    }
+
+    unsigned long long max() const {
+      unsigned long long result = 0;
+      for (auto &s : shards) {
+        result = std::max(result, s.max.load(std::memory_order_relaxed));
+      }
+      return result;
+    }
+
+    // estimate given percentile as upper bound of the bucket it falls into, 0 if nothing is recorded
+    unsigned long long percentile(unsigned percent) const {
+      unsigned long long counts[buckets] = {};
+      unsigned long long total = 0;
+      for (auto &s : shards) {
+        for (size_t i = 0; i < buckets; i++) {
+          auto count = s.counts[i].load(std::memory_order_relaxed);
+          counts[i] += count;
+          total += count;
+        }
+      }
+
+      if (total == 0) {
+        return 0;
+      }
+
+      unsigned long long rank = (total * percent + 99) / 100;
+      unsigned long long seen = 0;
+      for (size_t i = 0; i < buckets; i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+          return std::min((2ULL << i) - 1, max());
+        }
+      }
+      return max();
+    }
+};
+
 // define global status variables
-static unsigned long long time_spent_ms = 0;
-static unsigned long number_of_requests = 0;
+static sharded_counter time_spent_us;
+static sharded_counter number_of_requests;
+static sharded_counter failed_requests;
+static sharded_counter responses_1xx;
+static sharded_counter responses_2xx;
+static sharded_counter responses_3xx;
+static sharded_counter responses_4xx;
+static sharded_counter responses_5xx;
+static sharded_counter *responses_by_class[] = {&responses_1xx, &responses_2xx, &responses_3xx, &responses_4xx, &responses_5xx};
+static sharded_counter bytes_sent;
+static sharded_counter bytes_received;
+static std::atomic<unsigned long long> errors_by_code[CURL_LAST];
+static latency_histogram dns_latency;
+static latency_histogram connect_latency;
+static latency_histogram tls_latency;
+static latency_histogram ttfb_latency;
+static latency_histogram total_latency;
+static std::atomic<unsigned long long> nowait_dropped{0};
+static std::atomic<unsigned long long> nowait_completed{0};
+static std::atomic<unsigned long long> nowait_failed{0};
+static std::atomic<unsigned long long> async_memory_used{0};
+static std::atomic<unsigned long long> async_evicted{0};
+static std::atomic<unsigned long long> cache_hits{0};
+static std::atomic<unsigned long long> cache_misses{0};
+static std::atomic<unsigned long long> cache_revalidations{0};
+static std::atomic<unsigned long long> cache_evictions{0};
+static std::atomic<unsigned long long> cache_bytes{0};
+static std::atomic<unsigned long long> compressed_requests{0};
+static std::atomic<unsigned long long> compression_bytes_in{0};
+static std::atomic<unsigned long long> compression_bytes_out{0};
+static std::atomic<unsigned long long> compression_time_us{0};
+static std::atomic<unsigned long long> json_extract_stopped{0};
+static std::atomic<unsigned long long> preconnected{0};
+static std::atomic<unsigned long long> aborted_requests{0};
+static std::atomic<unsigned long long> coalesced_requests{0};
+static std::atomic<unsigned long long> coalesce_fallbacks{0};
+static std::atomic<unsigned long long> multiplexed_requests{0};
+static std::atomic<unsigned long long> log_dropped{0};
+static std::atomic<unsigned long long> host_limit_timeouts{0};
+static std::atomic<unsigned long long> breaker_rejected{0};
+static std::atomic<unsigned long long> breakers_open{0};
+static std::atomic<unsigned long long> retried_requests{0};
+static std::atomic<unsigned long long> hedged_requests{0};
+static std::atomic<unsigned long long> hedge_wins{0};
+
+// show current value of an atomic counter
+template <std::atomic<unsigned long long> *counter>
+static int show_counter(MYSQL_THD, SHOW_VAR *var, char *buf) {
+  var->type = SHOW_LONGLONG;
+  var->value = buf;
+  *reinterpret_cast<unsigned long long *>(buf) = counter->load(std::memory_order_relaxed);
+  return 0;
+}
+
+// show aggregated value of a sharded counter
+template <sharded_counter *counter>
+static int show_sharded_counter(MYSQL_THD, SHOW_VAR *var, char *buf) {
+  var->type = SHOW_LONGLONG;
+  var->value = buf;
+  *reinterpret_cast<unsigned long long *>(buf) = counter->load();
+  return 0;
+}
+
+// show a percentile of a latency histogram in microseconds, 100 shows the maximum
+template <latency_histogram *histogram, unsigned percent>
+static int show_latency(MYSQL_THD, SHOW_VAR *var, char *buf) {
+  var->type = SHOW_LONGLONG;
+  var->value = buf;
+  *reinterpret_cast<unsigned long long *>(buf) = percent >= 100 ? histogram->max() : histogram->percentile(percent);
+  return 0;
+}
+
+// show total time spent in requests
+static int show_time_spent_ms(MYSQL_THD, SHOW_VAR *var, char *buf) {
+  var->type = SHOW_LONGLONG;
+  var->value = buf;
+  *reinterpret_cast<unsigned long long *>(buf) = time_spent_us.load() / 1000;
+  return 0;
+}
+
+// show failed transfers by curl error code as a list of "code:count"
+static int show_errors_by_code(MYSQL_THD, SHOW_VAR *var, char *buf) {
+  var->type = SHOW_CHAR;
+  var->value = buf;
+
+  std::string value;
+  for (int code = 1; code < CURL_LAST; code++) {
+    auto count = errors_by_code[code].load(std::memory_order_relaxed);
+    if (count > 0) {
+      value += (value.empty() ? "" : ",") + std::to_string(code) + ":" + std::to_string(count);
+    }
+  }
+
+  snprintf(buf, SHOW_VAR_FUNC_BUFF_SIZE, "%s", value.c_str());
+  return 0;
+}
+
+static int show_nowait_queue_depth(MYSQL_THD, SHOW_VAR *var, char *buf);
+static int show_breaker_state(MYSQL_THD, SHOW_VAR *var, char *buf);
 
 static SHOW_VAR httpclient_status_variables[] = {
-  {"httpclient.time_spent_ms", (char *)&time_spent_ms, SHOW_LONGLONG, SHOW_SCOPE_GLOBAL},
-  {"httpclient.number_of_requests", (char *)&number_of_requests, SHOW_LONG, SHOW_SCOPE_GLOBAL}
+  {"httpclient.time_spent_ms", (char *)&show_time_spent_ms, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.number_of_requests", (char *)&show_sharded_counter<&number_of_requests>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.failed_requests", (char *)&show_sharded_counter<&failed_requests>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.errors_by_code", (char *)&show_errors_by_code, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.responses_1xx", (char *)&show_sharded_counter<&responses_1xx>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.responses_2xx", (char *)&show_sharded_counter<&responses_2xx>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.responses_3xx", (char *)&show_sharded_counter<&responses_3xx>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.responses_4xx", (char *)&show_sharded_counter<&responses_4xx>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.responses_5xx", (char *)&show_sharded_counter<&responses_5xx>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.bytes_sent", (char *)&show_sharded_counter<&bytes_sent>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.bytes_received", (char *)&show_sharded_counter<&bytes_received>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.latency_dns_p50_us", (char *)&show_latency<&dns_latency, 50>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.latency_dns_p90_us", (char *)&show_latency<&dns_latency, 90>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.latency_dns_p99_us", (char *)&show_latency<&dns_latency, 99>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.latency_dns_max_us", (char *)&show_latency<&dns_latency, 100>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.latency_connect_p50_us", (char *)&show_latency<&connect_latency, 50>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.latency_connect_p90_us", (char *)&show_latency<&connect_latency, 90>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.latency_connect_p99_us", (char *)&show_latency<&connect_latency, 99>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.latency_connect_max_us", (char *)&show_latency<&connect_latency, 100>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.latency_tls_p50_us", (char *)&show_latency<&tls_latency, 50>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.latency_tls_p90_us", (char *)&show_latency<&tls_latency, 90>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.latency_tls_p99_us", (char *)&show_latency<&tls_latency, 99>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.latency_tls_max_us", (char *)&show_latency<&tls_latency, 100>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.latency_ttfb_p50_us", (char *)&show_latency<&ttfb_latency, 50>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.latency_ttfb_p90_us", (char *)&show_latency<&ttfb_latency, 90>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.latency_ttfb_p99_us", (char *)&show_latency<&ttfb_latency, 99>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.latency_ttfb_max_us", (char *)&show_latency<&ttfb_latency, 100>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.latency_total_p50_us", (char *)&show_latency<&total_latency, 50>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.latency_total_p90_us", (char *)&show_latency<&total_latency, 90>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.latency_total_p99_us", (char *)&show_latency<&total_latency, 99>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.latency_total_max_us", (char *)&show_latency<&total_latency, 100>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.nowait_queue_depth", (char *)&show_nowait_queue_depth, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.nowait_dropped", (char *)&show_counter<&nowait_dropped>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.nowait_completed", (char *)&show_counter<&nowait_completed>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.nowait_failed", (char *)&show_counter<&nowait_failed>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.async_memory_used", (char *)&show_counter<&async_memory_used>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.async_evicted", (char *)&show_counter<&async_evicted>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.cache_hits", (char *)&show_counter<&cache_hits>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.cache_misses", (char *)&show_counter<&cache_misses>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.cache_revalidations", (char *)&show_counter<&cache_revalidations>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.cache_evictions", (char *)&show_counter<&cache_evictions>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.log_dropped", (char *)&show_counter<&log_dropped>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.host_limit_timeouts", (char *)&show_counter<&host_limit_timeouts>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.breaker_rejected", (char *)&show_counter<&breaker_rejected>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.breakers_open", (char *)&show_counter<&breakers_open>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.breaker_state", (char *)&show_breaker_state, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.retried_requests", (char *)&show_counter<&retried_requests>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.hedged_requests", (char *)&show_counter<&hedged_requests>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.hedge_wins", (char *)&show_counter<&hedge_wins>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.cache_bytes", (char *)&show_counter<&cache_bytes>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.compressed_requests", (char *)&show_counter<&compressed_requests>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.compression_bytes_in", (char *)&show_counter<&compression_bytes_in>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.compression_bytes_out", (char *)&show_counter<&compression_bytes_out>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.compression_time_us", (char *)&show_counter<&compression_time_us>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.json_extract_stopped", (char *)&show_counter<&json_extract_stopped>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.preconnected", (char *)&show_counter<&preconnected>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.aborted_requests", (char *)&show_counter<&aborted_requests>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.coalesced_requests", (char *)&show_counter<&coalesced_requests>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.coalesce_fallbacks", (char *)&show_counter<&coalesce_fallbacks>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {"httpclient.multiplexed_requests", (char *)&show_counter<&multiplexed_requests>, SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+  {nullptr, nullptr, SHOW_UNDEF, SHOW_SCOPE_UNDEF}
+};
+
+// define global system variables
+static uint connection_pool_size = 16;
+static uint nowait_queue_size = 1024;
+static uint nowait_max_in_flight = 64;
+static uint nowait_timeout_ms = 30000;
+static ulong nowait_overflow_policy = 1;
+static ulong async_memory_limit = 64 * 1024 * 1024;
+static uint async_response_ttl = 600;
+static uint multi_max_in_flight = 16;
+static uint multi_max_host_connections = 0;
+static uint batch_max_rows = 1000;
+static ulong batch_max_bytes = 4 * 1024 * 1024;
+static ulong batch_format = 0;
+static ulong cache_size = 0;
+static ulong max_response_size = 0;
+static uint request_history_size = 1000;
+static uint request_history_ttl = 3600;
+static ulong log_level = 2;
+static uint log_sample_rate = 1;
+static uint log_slow_ms = 1000;
+static uint host_max_in_flight = 0;
+static uint host_rate_limit = 0;
+static uint host_wait_timeout_ms = 10000;
+static uint breaker_failure_threshold = 0;
+static uint breaker_latency_ms = 0;
+static uint breaker_open_ms = 30000;
+static bool accept_encoding = true;
+static uint compress_min_size = 1024;
+static char *preconnect_urls = nullptr;
+static uint preconnect_connections = 2;
+static bool multiplex = false;
+static uint max_concurrent_streams = 100;
+
+// define overflow policies of background request queue
+enum nowait_overflow_policies { NOWAIT_OVERFLOW_BLOCK, NOWAIT_OVERFLOW_DROP, NOWAIT_OVERFLOW_ERROR };
+static const char *nowait_overflow_policy_names[] = {"BLOCK", "DROP", "ERROR", nullptr};
+static TYPELIB nowait_overflow_policy_typelib = {3, "nowait_overflow_policy_typelib", nowait_overflow_policy_names, nullptr};
+
+// define body formats of http_request_batch
+enum batch_formats { BATCH_FORMAT_NDJSON, BATCH_FORMAT_JSON_ARRAY };
+static const char *batch_format_names[] = {"NDJSON", "JSON_ARRAY", nullptr};
+static TYPELIB batch_format_typelib = {2, "batch_format_typelib", batch_format_names, nullptr};
+
+// define which requests are written to error log
+// ERROR logs failed transfers, WARNING also logs slow requests and 5xx responses, INFORMATION logs all requests
+enum log_levels { LOG_LEVEL_NONE, LOG_LEVEL_ERROR, LOG_LEVEL_WARNING, LOG_LEVEL_INFORMATION };
+static const char *log_level_names[] = {"NONE", "ERROR", "WARNING", "INFORMATION", nullptr};
+static TYPELIB log_level_typelib = {4, "log_level_typelib", log_level_names, nullptr};
+
+// define a supported curl option and the type of its value
+struct curl_option_definition {
+  std::string_view name;
+  CURLoption option;
+  long type;
 };
 
-// define all supported curl options that are int, long and string types
-static std::map<std::string, std::tuple<CURLoption, long>> curl_options_available = {
-  {"CURLOPT_ACCEPTTIMEOUT_MS", std::make_tuple(CURLOPT_ACCEPTTIMEOUT_MS, CURLOPTTYPE_LONG)},
-  {"CURLOPT_ACCEPT_ENCODING", std::make_tuple(CURLOPT_ACCEPT_ENCODING, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_ADDRESS_SCOPE", std::make_tuple(CURLOPT_ADDRESS_SCOPE, CURLOPTTYPE_LONG)},
-  {"CURLOPT_APPEND", std::make_tuple(CURLOPT_APPEND, CURLOPTTYPE_LONG)},
-  {"CURLOPT_AUTOREFERER", std::make_tuple(CURLOPT_AUTOREFERER, CURLOPTTYPE_LONG)},
-  {"CURLOPT_BUFFERSIZE", std::make_tuple(CURLOPT_BUFFERSIZE, CURLOPTTYPE_LONG)},
-  {"CURLOPT_CAINFO", std::make_tuple(CURLOPT_CAINFO, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_CAPATH", std::make_tuple(CURLOPT_CAPATH, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_CERTINFO", std::make_tuple(CURLOPT_CERTINFO, CURLOPTTYPE_LONG)},
-  {"CURLOPT_CONNECTTIMEOUT", std::make_tuple(CURLOPT_CONNECTTIMEOUT, CURLOPTTYPE_LONG)},
-  {"CURLOPT_CONNECTTIMEOUT_MS", std::make_tuple(CURLOPT_CONNECTTIMEOUT_MS, CURLOPTTYPE_LONG)},
-  {"CURLOPT_CONNECT_ONLY", std::make_tuple(CURLOPT_CONNECT_ONLY, CURLOPTTYPE_LONG)},
-  {"CURLOPT_COOKIE", std::make_tuple(CURLOPT_COOKIE, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_COOKIEFILE", std::make_tuple(CURLOPT_COOKIEFILE, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_COOKIEJAR", std::make_tuple(CURLOPT_COOKIEJAR, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_COOKIELIST", std::make_tuple(CURLOPT_COOKIELIST, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_COOKIESESSION", std::make_tuple(CURLOPT_COOKIESESSION, CURLOPTTYPE_LONG)},
-  {"CURLOPT_COPYPOSTFIELDS", std::make_tuple(CURLOPT_COPYPOSTFIELDS, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_CRLF", std::make_tuple(CURLOPT_CRLF, CURLOPTTYPE_LONG)},
-  {"CURLOPT_CRLFILE", std::make_tuple(CURLOPT_CRLFILE, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_CUSTOMREQUEST", std::make_tuple(CURLOPT_CUSTOMREQUEST, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_DIRLISTONLY", std::make_tuple(CURLOPT_DIRLISTONLY, CURLOPTTYPE_LONG)},
-  {"CURLOPT_DNS_CACHE_TIMEOUT", std::make_tuple(CURLOPT_DNS_CACHE_TIMEOUT, CURLOPTTYPE_LONG)},
-  {"CURLOPT_DNS_INTERFACE", std::make_tuple(CURLOPT_DNS_INTERFACE, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_DNS_LOCAL_IP4", std::make_tuple(CURLOPT_DNS_LOCAL_IP4, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_DNS_LOCAL_IP6", std::make_tuple(CURLOPT_DNS_LOCAL_IP6, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_DNS_SERVERS", std::make_tuple(CURLOPT_DNS_SERVERS, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_DNS_USE_GLOBAL_CACHE", std::make_tuple(CURLOPT_DNS_USE_GLOBAL_CACHE, CURLOPTTYPE_LONG)},
-  {"CURLOPT_DOH_URL", std::make_tuple(CURLOPT_DOH_URL, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_EGDSOCKET", std::make_tuple(CURLOPT_EGDSOCKET, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_EXPECT_100_TIMEOUT_MS", std::make_tuple(CURLOPT_EXPECT_100_TIMEOUT_MS, CURLOPTTYPE_LONG)},
-  {"CURLOPT_FAILONERROR", std::make_tuple(CURLOPT_FAILONERROR, CURLOPTTYPE_LONG)},
-  {"CURLOPT_FILETIME", std::make_tuple(CURLOPT_FILETIME, CURLOPTTYPE_LONG)},
-  {"CURLOPT_FOLLOWLOCATION", std::make_tuple(CURLOPT_FOLLOWLOCATION, CURLOPTTYPE_LONG)},
-  {"CURLOPT_FORBID_REUSE", std::make_tuple(CURLOPT_FORBID_REUSE, CURLOPTTYPE_LONG)},
-  {"CURLOPT_FRESH_CONNECT", std::make_tuple(CURLOPT_FRESH_CONNECT, CURLOPTTYPE_LONG)},
-  {"CURLOPT_FTPAPPEND", std::make_tuple(CURLOPT_FTPAPPEND, CURLOPTTYPE_LONG)},
-  {"CURLOPT_FTPLISTONLY", std::make_tuple(CURLOPT_FTPLISTONLY, CURLOPTTYPE_LONG)},
-  {"CURLOPT_FTPPORT", std::make_tuple(CURLOPT_FTPPORT, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_FTPSSLAUTH", std::make_tuple(CURLOPT_FTPSSLAUTH, CURLOPTTYPE_LONG)},
-  {"CURLOPT_FTP_ACCOUNT", std::make_tuple(CURLOPT_FTP_ACCOUNT, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_FTP_ALTERNATIVE_TO_USER", std::make_tuple(CURLOPT_FTP_ALTERNATIVE_TO_USER, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_FTP_CREATE_MISSING_DIRS", std::make_tuple(CURLOPT_FTP_CREATE_MISSING_DIRS, CURLOPTTYPE_LONG)},
-  {"CURLOPT_FTP_FILEMETHOD", std::make_tuple(CURLOPT_FTP_FILEMETHOD, CURLOPTTYPE_LONG)},
-  {"CURLOPT_FTP_RESPONSE_TIMEOUT", std::make_tuple(CURLOPT_FTP_RESPONSE_TIMEOUT, CURLOPTTYPE_LONG)},
-  {"CURLOPT_FTP_SKIP_PASV_IP", std::make_tuple(CURLOPT_FTP_SKIP_PASV_IP, CURLOPTTYPE_LONG)},
-  {"CURLOPT_FTP_SSL", std::make_tuple(CURLOPT_FTP_SSL, CURLOPTTYPE_LONG)},
-  {"CURLOPT_FTP_SSL_CCC", std::make_tuple(CURLOPT_FTP_SSL_CCC, CURLOPTTYPE_LONG)},
-  {"CURLOPT_FTP_USE_EPRT", std::make_tuple(CURLOPT_FTP_USE_EPRT, CURLOPTTYPE_LONG)},
-  {"CURLOPT_FTP_USE_EPSV", std::make_tuple(CURLOPT_FTP_USE_EPSV, CURLOPTTYPE_LONG)},
-  {"CURLOPT_FTP_USE_PRET", std::make_tuple(CURLOPT_FTP_USE_PRET, CURLOPTTYPE_LONG)},
-  {"CURLOPT_HEADER", std::make_tuple(CURLOPT_HEADER, CURLOPTTYPE_LONG)},
-  {"CURLOPT_HTTP09_ALLOWED", std::make_tuple(CURLOPT_HTTP09_ALLOWED, CURLOPTTYPE_LONG)},
-  {"CURLOPT_HTTPAUTH", std::make_tuple(CURLOPT_HTTPAUTH, CURLOPTTYPE_LONG)},
-  {"CURLOPT_HTTPGET", std::make_tuple(CURLOPT_HTTPGET, CURLOPTTYPE_LONG)},
-  {"CURLOPT_HTTPPROXYTUNNEL", std::make_tuple(CURLOPT_HTTPPROXYTUNNEL, CURLOPTTYPE_LONG)},
-  {"CURLOPT_HTTP_CONTENT_DECODING", std::make_tuple(CURLOPT_HTTP_CONTENT_DECODING, CURLOPTTYPE_LONG)},
-  {"CURLOPT_HTTP_TRANSFER_DECODING", std::make_tuple(CURLOPT_HTTP_TRANSFER_DECODING, CURLOPTTYPE_LONG)},
-  {"CURLOPT_HTTP_VERSION", std::make_tuple(CURLOPT_HTTP_VERSION, CURLOPTTYPE_LONG)},
-  {"CURLOPT_IGNORE_CONTENT_LENGTH", std::make_tuple(CURLOPT_IGNORE_CONTENT_LENGTH, CURLOPTTYPE_LONG)},
-  {"CURLOPT_INFILESIZE", std::make_tuple(CURLOPT_INFILESIZE, CURLOPTTYPE_LONG)},
-  {"CURLOPT_INTERFACE", std::make_tuple(CURLOPT_INTERFACE, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_IPRESOLVE", std::make_tuple(CURLOPT_IPRESOLVE, CURLOPTTYPE_LONG)},
-  {"CURLOPT_ISSUERCERT", std::make_tuple(CURLOPT_ISSUERCERT, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_KEYPASSWD", std::make_tuple(CURLOPT_KEYPASSWD, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_KRB4LEVEL", std::make_tuple(CURLOPT_KRB4LEVEL, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_LOCALPORT", std::make_tuple(CURLOPT_LOCALPORT, CURLOPTTYPE_LONG)},
-  {"CURLOPT_LOCALPORTRANGE", std::make_tuple(CURLOPT_LOCALPORTRANGE, CURLOPTTYPE_LONG)},
-  {"CURLOPT_LOW_SPEED_LIMIT", std::make_tuple(CURLOPT_LOW_SPEED_LIMIT, CURLOPTTYPE_LONG)},
-  {"CURLOPT_LOW_SPEED_TIME", std::make_tuple(CURLOPT_LOW_SPEED_TIME, CURLOPTTYPE_LONG)},
-  {"CURLOPT_MAIL_FROM", std::make_tuple(CURLOPT_MAIL_FROM, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_MAXCONNECTS", std::make_tuple(CURLOPT_MAXCONNECTS, CURLOPTTYPE_LONG)},
-  {"CURLOPT_MAXFILESIZE", std::make_tuple(CURLOPT_MAXFILESIZE, CURLOPTTYPE_LONG)},
-  {"CURLOPT_MAXFILESIZE_LARGE", std::make_tuple(CURLOPT_MAXFILESIZE_LARGE, CURLOPTTYPE_OFF_T)},
-  {"CURLOPT_MAXREDIRS", std::make_tuple(CURLOPT_MAXREDIRS, CURLOPTTYPE_LONG)},
-  {"CURLOPT_MAX_RECV_SPEED_LARGE", std::make_tuple(CURLOPT_MAX_RECV_SPEED_LARGE, CURLOPTTYPE_OFF_T)},
-  {"CURLOPT_MAX_SEND_SPEED_LARGE", std::make_tuple(CURLOPT_MAX_SEND_SPEED_LARGE, CURLOPTTYPE_OFF_T)},
-  {"CURLOPT_NETRC", std::make_tuple(CURLOPT_NETRC, CURLOPTTYPE_LONG)},
-  {"CURLOPT_NETRC_FILE", std::make_tuple(CURLOPT_NETRC_FILE, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_NEW_DIRECTORY_PERMS", std::make_tuple(CURLOPT_NEW_DIRECTORY_PERMS, CURLOPTTYPE_LONG)},
-  {"CURLOPT_NEW_FILE_PERMS", std::make_tuple(CURLOPT_NEW_FILE_PERMS, CURLOPTTYPE_LONG)},
-  {"CURLOPT_NOBODY", std::make_tuple(CURLOPT_NOBODY, CURLOPTTYPE_LONG)},
-  {"CURLOPT_NOPROGRESS", std::make_tuple(CURLOPT_NOPROGRESS, CURLOPTTYPE_LONG)},
-  {"CURLOPT_NOPROXY", std::make_tuple(CURLOPT_NOPROXY, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_NOSIGNAL", std::make_tuple(CURLOPT_NOSIGNAL, CURLOPTTYPE_LONG)},
-  {"CURLOPT_PATH_AS_IS", std::make_tuple(CURLOPT_PATH_AS_IS, CURLOPTTYPE_LONG)},
-  {"CURLOPT_PINNEDPUBLICKEY", std::make_tuple(CURLOPT_PINNEDPUBLICKEY, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_PIPEWAIT", std::make_tuple(CURLOPT_PIPEWAIT, CURLOPTTYPE_LONG)},
-  {"CURLOPT_PORT", std::make_tuple(CURLOPT_PORT, CURLOPTTYPE_LONG)},
-  {"CURLOPT_POST", std::make_tuple(CURLOPT_POST, CURLOPTTYPE_LONG)},
-  {"CURLOPT_POSTFIELDS", std::make_tuple(CURLOPT_POSTFIELDS, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_POSTFIELDSIZE", std::make_tuple(CURLOPT_POSTFIELDSIZE, CURLOPTTYPE_LONG)},
-  {"CURLOPT_POSTFIELDSIZE_LARGE", std::make_tuple(CURLOPT_POSTFIELDSIZE_LARGE, CURLOPTTYPE_OFF_T)},
-  {"CURLOPT_PROTOCOLS", std::make_tuple(CURLOPT_PROTOCOLS, CURLOPTTYPE_LONG)},
-  {"CURLOPT_PROXY", std::make_tuple(CURLOPT_PROXY, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_PROXYAUTH", std::make_tuple(CURLOPT_PROXYAUTH, CURLOPTTYPE_LONG)},
-  {"CURLOPT_PROXYPASSWORD", std::make_tuple(CURLOPT_PROXYPASSWORD, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_PROXYPORT", std::make_tuple(CURLOPT_PROXYPORT, CURLOPTTYPE_LONG)},
-  {"CURLOPT_PROXYTYPE", std::make_tuple(CURLOPT_PROXYTYPE, CURLOPTTYPE_LONG)},
-  {"CURLOPT_PROXYUSERNAME", std::make_tuple(CURLOPT_PROXYUSERNAME, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_PROXYUSERPWD", std::make_tuple(CURLOPT_PROXYUSERPWD, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_PUT", std::make_tuple(CURLOPT_PUT, CURLOPTTYPE_LONG)},
-  {"CURLOPT_RANDOM_FILE", std::make_tuple(CURLOPT_RANDOM_FILE, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_RANGE", std::make_tuple(CURLOPT_RANGE, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_REDIR_PROTOCOLS", std::make_tuple(CURLOPT_REDIR_PROTOCOLS, CURLOPTTYPE_LONG)},
-  {"CURLOPT_RESUME_FROM", std::make_tuple(CURLOPT_RESUME_FROM, CURLOPTTYPE_LONG)},
-  {"CURLOPT_RESUME_FROM_LARGE", std::make_tuple(CURLOPT_RESUME_FROM_LARGE, CURLOPTTYPE_OFF_T)},
-  {"CURLOPT_RTSP_CLIENT_CSEQ", std::make_tuple(CURLOPT_RTSP_CLIENT_CSEQ, CURLOPTTYPE_LONG)},
-  {"CURLOPT_RTSP_REQUEST", std::make_tuple(CURLOPT_RTSP_REQUEST, CURLOPTTYPE_LONG)},
-  {"CURLOPT_RTSP_SERVER_CSEQ", std::make_tuple(CURLOPT_RTSP_SERVER_CSEQ, CURLOPTTYPE_LONG)},
-  {"CURLOPT_RTSP_SESSION_ID", std::make_tuple(CURLOPT_RTSP_SESSION_ID, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_RTSP_STREAM_URI", std::make_tuple(CURLOPT_RTSP_STREAM_URI, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_RTSP_TRANSPORT", std::make_tuple(CURLOPT_RTSP_TRANSPORT, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_SASL_IR", std::make_tuple(CURLOPT_SASL_IR, CURLOPTTYPE_LONG)},
-  {"CURLOPT_SOCKS5_GSSAPI_NEC", std::make_tuple(CURLOPT_SOCKS5_GSSAPI_NEC, CURLOPTTYPE_LONG)},
-  {"CURLOPT_SOCKS5_GSSAPI_SERVICE", std::make_tuple(CURLOPT_SOCKS5_GSSAPI_SERVICE, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_SSH_AUTH_TYPES", std::make_tuple(CURLOPT_SSH_AUTH_TYPES, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_SSH_COMPRESSION", std::make_tuple(CURLOPT_SSH_COMPRESSION, CURLOPTTYPE_LONG)},
-  {"CURLOPT_SSH_HOST_PUBLIC_KEY_MD5", std::make_tuple(CURLOPT_SSH_HOST_PUBLIC_KEY_MD5, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_SSH_KNOWNHOSTS", std::make_tuple(CURLOPT_SSH_KNOWNHOSTS, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_SSH_PRIVATE_KEYFILE", std::make_tuple(CURLOPT_SSH_PRIVATE_KEYFILE, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_SSH_PUBLIC_KEYFILE", std::make_tuple(CURLOPT_SSH_PUBLIC_KEYFILE, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_SSLCERT", std::make_tuple(CURLOPT_SSLCERT, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_SSLCERTTYPE", std::make_tuple(CURLOPT_SSLCERTTYPE, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_SSL_CIPHER_LIST", std::make_tuple(CURLOPT_SSL_CIPHER_LIST, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_SSLENGINE", std::make_tuple(CURLOPT_SSLENGINE, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_SSLENGINE_DEFAULT", std::make_tuple(CURLOPT_SSLENGINE_DEFAULT, CURLOPTTYPE_LONG)},
-  {"CURLOPT_SSLKEY", std::make_tuple(CURLOPT_SSLKEY, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_SSLKEYTYPE", std::make_tuple(CURLOPT_SSLKEYTYPE, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_SSLVERSION", std::make_tuple(CURLOPT_SSLVERSION, CURLOPTTYPE_LONG)},
-  {"CURLOPT_SSL_OPTIONS", std::make_tuple(CURLOPT_SSL_OPTIONS, CURLOPTTYPE_LONG)},
-  {"CURLOPT_SSL_SESSIONID_CACHE", std::make_tuple(CURLOPT_SSL_SESSIONID_CACHE, CURLOPTTYPE_LONG)},
-  {"CURLOPT_SSL_VERIFYHOST", std::make_tuple(CURLOPT_SSL_VERIFYHOST, CURLOPTTYPE_LONG)},
-  {"CURLOPT_SSL_VERIFYPEER", std::make_tuple(CURLOPT_SSL_VERIFYPEER, CURLOPTTYPE_LONG)},
-  {"CURLOPT_SSL_VERIFYSTATUS", std::make_tuple(CURLOPT_SSL_VERIFYSTATUS, CURLOPTTYPE_LONG)},
-  {"CURLOPT_TCP_FASTOPEN", std::make_tuple(CURLOPT_TCP_FASTOPEN, CURLOPTTYPE_LONG)},
-  {"CURLOPT_TCP_KEEPALIVE", std::make_tuple(CURLOPT_TCP_KEEPALIVE, CURLOPTTYPE_LONG)},
-  {"CURLOPT_TCP_KEEPIDLE", std::make_tuple(CURLOPT_TCP_KEEPIDLE, CURLOPTTYPE_LONG)},
-  {"CURLOPT_TCP_KEEPINTVL", std::make_tuple(CURLOPT_TCP_KEEPINTVL, CURLOPTTYPE_LONG)},
-  {"CURLOPT_TCP_NODELAY", std::make_tuple(CURLOPT_TCP_NODELAY, CURLOPTTYPE_LONG)},
-  {"CURLOPT_TFTP_BLKSIZE", std::make_tuple(CURLOPT_TFTP_BLKSIZE, CURLOPTTYPE_LONG)},
-  {"CURLOPT_TFTP_NO_OPTIONS", std::make_tuple(CURLOPT_TFTP_NO_OPTIONS, CURLOPTTYPE_LONG)},
-  {"CURLOPT_TIMECONDITION", std::make_tuple(CURLOPT_TIMECONDITION, CURLOPTTYPE_LONG)},
-  {"CURLOPT_TIMEOUT", std::make_tuple(CURLOPT_TIMEOUT, CURLOPTTYPE_LONG)},
-  {"CURLOPT_TIMEOUT_MS", std::make_tuple(CURLOPT_TIMEOUT_MS, CURLOPTTYPE_LONG)},
-  {"CURLOPT_TIMEVALUE", std::make_tuple(CURLOPT_TIMEVALUE, CURLOPTTYPE_LONG)},
-  {"CURLOPT_TLSAUTH_PASSWORD", std::make_tuple(CURLOPT_TLSAUTH_PASSWORD, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_TLSAUTH_TYPE", std::make_tuple(CURLOPT_TLSAUTH_TYPE, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_TLSAUTH_USERNAME", std::make_tuple(CURLOPT_TLSAUTH_USERNAME, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_TRANSFERTEXT", std::make_tuple(CURLOPT_TRANSFERTEXT, CURLOPTTYPE_LONG)},
-  {"CURLOPT_UNIX_SOCKET_PATH", std::make_tuple(CURLOPT_UNIX_SOCKET_PATH, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_UNRESTRICTED_AUTH", std::make_tuple(CURLOPT_UNRESTRICTED_AUTH, CURLOPTTYPE_LONG)},
-  {"CURLOPT_UPLOAD", std::make_tuple(CURLOPT_UPLOAD, CURLOPTTYPE_LONG)},
-  {"CURLOPT_URL", std::make_tuple(CURLOPT_URL, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_USERAGENT", std::make_tuple(CURLOPT_USERAGENT, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_USERNAME", std::make_tuple(CURLOPT_USERNAME, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_USERPWD", std::make_tuple(CURLOPT_USERPWD, CURLOPTTYPE_STRINGPOINT)},
-  {"CURLOPT_USE_SSL", std::make_tuple(CURLOPT_USE_SSL, CURLOPTTYPE_LONG)},
-  {"CURLOPT_VERBOSE", std::make_tuple(CURLOPT_VERBOSE, CURLOPTTYPE_LONG)},
-  {"CURLOPT_WILDCARDMATCH", std::make_tuple(CURLOPT_WILDCARDMATCH, CURLOPTTYPE_LONG)}
+// define all supported curl options that are int, long, off_t and string types
+static constexpr curl_option_definition curl_options_available[] = {
+  {"CURLOPT_ACCEPTTIMEOUT_MS", CURLOPT_ACCEPTTIMEOUT_MS, CURLOPTTYPE_LONG},
+  {"CURLOPT_ACCEPT_ENCODING", CURLOPT_ACCEPT_ENCODING, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_ADDRESS_SCOPE", CURLOPT_ADDRESS_SCOPE, CURLOPTTYPE_LONG},
+  {"CURLOPT_APPEND", CURLOPT_APPEND, CURLOPTTYPE_LONG},
+  {"CURLOPT_AUTOREFERER", CURLOPT_AUTOREFERER, CURLOPTTYPE_LONG},
+  {"CURLOPT_BUFFERSIZE", CURLOPT_BUFFERSIZE, CURLOPTTYPE_LONG},
+  {"CURLOPT_CAINFO", CURLOPT_CAINFO, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_CAPATH", CURLOPT_CAPATH, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_CERTINFO", CURLOPT_CERTINFO, CURLOPTTYPE_LONG},
+  {"CURLOPT_CONNECTTIMEOUT", CURLOPT_CONNECTTIMEOUT, CURLOPTTYPE_LONG},
+  {"CURLOPT_CONNECTTIMEOUT_MS", CURLOPT_CONNECTTIMEOUT_MS, CURLOPTTYPE_LONG},
+  {"CURLOPT_CONNECT_ONLY", CURLOPT_CONNECT_ONLY, CURLOPTTYPE_LONG},
+  {"CURLOPT_COOKIE", CURLOPT_COOKIE, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_COOKIEFILE", CURLOPT_COOKIEFILE, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_COOKIEJAR", CURLOPT_COOKIEJAR, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_COOKIELIST", CURLOPT_COOKIELIST, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_COOKIESESSION", CURLOPT_COOKIESESSION, CURLOPTTYPE_LONG},
+  {"CURLOPT_COPYPOSTFIELDS", CURLOPT_COPYPOSTFIELDS, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_CRLF", CURLOPT_CRLF, CURLOPTTYPE_LONG},
+  {"CURLOPT_CRLFILE", CURLOPT_CRLFILE, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_CUSTOMREQUEST", CURLOPT_CUSTOMREQUEST, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_DIRLISTONLY", CURLOPT_DIRLISTONLY, CURLOPTTYPE_LONG},
+  {"CURLOPT_DNS_CACHE_TIMEOUT", CURLOPT_DNS_CACHE_TIMEOUT, CURLOPTTYPE_LONG},
+  {"CURLOPT_DNS_INTERFACE", CURLOPT_DNS_INTERFACE, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_DNS_LOCAL_IP4", CURLOPT_DNS_LOCAL_IP4, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_DNS_LOCAL_IP6", CURLOPT_DNS_LOCAL_IP6, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_DNS_SERVERS", CURLOPT_DNS_SERVERS, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_DNS_USE_GLOBAL_CACHE", CURLOPT_DNS_USE_GLOBAL_CACHE, CURLOPTTYPE_LONG},
+  {"CURLOPT_DOH_URL", CURLOPT_DOH_URL, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_EGDSOCKET", CURLOPT_EGDSOCKET, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_EXPECT_100_TIMEOUT_MS", CURLOPT_EXPECT_100_TIMEOUT_MS, CURLOPTTYPE_LONG},
+  {"CURLOPT_FAILONERROR", CURLOPT_FAILONERROR, CURLOPTTYPE_LONG},
+  {"CURLOPT_FILETIME", CURLOPT_FILETIME, CURLOPTTYPE_LONG},
+  {"CURLOPT_FOLLOWLOCATION", CURLOPT_FOLLOWLOCATION, CURLOPTTYPE_LONG},
+  {"CURLOPT_FORBID_REUSE", CURLOPT_FORBID_REUSE, CURLOPTTYPE_LONG},
+  {"CURLOPT_FRESH_CONNECT", CURLOPT_FRESH_CONNECT, CURLOPTTYPE_LONG},
+  {"CURLOPT_FTPAPPEND", CURLOPT_FTPAPPEND, CURLOPTTYPE_LONG},
+  {"CURLOPT_FTPLISTONLY", CURLOPT_FTPLISTONLY, CURLOPTTYPE_LONG},
+  {"CURLOPT_FTPPORT", CURLOPT_FTPPORT, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_FTPSSLAUTH", CURLOPT_FTPSSLAUTH, CURLOPTTYPE_LONG},
+  {"CURLOPT_FTP_ACCOUNT", CURLOPT_FTP_ACCOUNT, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_FTP_ALTERNATIVE_TO_USER", CURLOPT_FTP_ALTERNATIVE_TO_USER, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_FTP_CREATE_MISSING_DIRS", CURLOPT_FTP_CREATE_MISSING_DIRS, CURLOPTTYPE_LONG},
+  {"CURLOPT_FTP_FILEMETHOD", CURLOPT_FTP_FILEMETHOD, CURLOPTTYPE_LONG},
+  {"CURLOPT_FTP_RESPONSE_TIMEOUT", CURLOPT_FTP_RESPONSE_TIMEOUT, CURLOPTTYPE_LONG},
+  {"CURLOPT_FTP_SKIP_PASV_IP", CURLOPT_FTP_SKIP_PASV_IP, CURLOPTTYPE_LONG},
+  {"CURLOPT_FTP_SSL", CURLOPT_FTP_SSL, CURLOPTTYPE_LONG},
+  {"CURLOPT_FTP_SSL_CCC", CURLOPT_FTP_SSL_CCC, CURLOPTTYPE_LONG},
+  {"CURLOPT_FTP_USE_EPRT", CURLOPT_FTP_USE_EPRT, CURLOPTTYPE_LONG},
+  {"CURLOPT_FTP_USE_EPSV", CURLOPT_FTP_USE_EPSV, CURLOPTTYPE_LONG},
+  {"CURLOPT_FTP_USE_PRET", CURLOPT_FTP_USE_PRET, CURLOPTTYPE_LONG},
+  {"CURLOPT_HEADER", CURLOPT_HEADER, CURLOPTTYPE_LONG},
+  {"CURLOPT_HTTP09_ALLOWED", CURLOPT_HTTP09_ALLOWED, CURLOPTTYPE_LONG},
+  {"CURLOPT_HTTPAUTH", CURLOPT_HTTPAUTH, CURLOPTTYPE_LONG},
+  {"CURLOPT_HTTPGET", CURLOPT_HTTPGET, CURLOPTTYPE_LONG},
+  {"CURLOPT_HTTPPROXYTUNNEL", CURLOPT_HTTPPROXYTUNNEL, CURLOPTTYPE_LONG},
+  {"CURLOPT_HTTP_CONTENT_DECODING", CURLOPT_HTTP_CONTENT_DECODING, CURLOPTTYPE_LONG},
+  {"CURLOPT_HTTP_TRANSFER_DECODING", CURLOPT_HTTP_TRANSFER_DECODING, CURLOPTTYPE_LONG},
+  {"CURLOPT_HTTP_VERSION", CURLOPT_HTTP_VERSION, CURLOPTTYPE_LONG},
+  {"CURLOPT_IGNORE_CONTENT_LENGTH", CURLOPT_IGNORE_CONTENT_LENGTH, CURLOPTTYPE_LONG},
+  {"CURLOPT_INFILESIZE", CURLOPT_INFILESIZE, CURLOPTTYPE_LONG},
+  {"CURLOPT_INTERFACE", CURLOPT_INTERFACE, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_IPRESOLVE", CURLOPT_IPRESOLVE, CURLOPTTYPE_LONG},
+  {"CURLOPT_ISSUERCERT", CURLOPT_ISSUERCERT, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_KEYPASSWD", CURLOPT_KEYPASSWD, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_KRB4LEVEL", CURLOPT_KRB4LEVEL, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_LOCALPORT", CURLOPT_LOCALPORT, CURLOPTTYPE_LONG},
+  {"CURLOPT_LOCALPORTRANGE", CURLOPT_LOCALPORTRANGE, CURLOPTTYPE_LONG},
+  {"CURLOPT_LOW_SPEED_LIMIT", CURLOPT_LOW_SPEED_LIMIT, CURLOPTTYPE_LONG},
+  {"CURLOPT_LOW_SPEED_TIME", CURLOPT_LOW_SPEED_TIME, CURLOPTTYPE_LONG},
+  {"CURLOPT_MAIL_FROM", CURLOPT_MAIL_FROM, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_MAXCONNECTS", CURLOPT_MAXCONNECTS, CURLOPTTYPE_LONG},
+  {"CURLOPT_MAXFILESIZE", CURLOPT_MAXFILESIZE, CURLOPTTYPE_LONG},
+  {"CURLOPT_MAXFILESIZE_LARGE", CURLOPT_MAXFILESIZE_LARGE, CURLOPTTYPE_OFF_T},
+  {"CURLOPT_MAXREDIRS", CURLOPT_MAXREDIRS, CURLOPTTYPE_LONG},
+  {"CURLOPT_MAX_RECV_SPEED_LARGE", CURLOPT_MAX_RECV_SPEED_LARGE, CURLOPTTYPE_OFF_T},
+  {"CURLOPT_MAX_SEND_SPEED_LARGE", CURLOPT_MAX_SEND_SPEED_LARGE, CURLOPTTYPE_OFF_T},
+  {"CURLOPT_NETRC", CURLOPT_NETRC, CURLOPTTYPE_LONG},
+  {"CURLOPT_NETRC_FILE", CURLOPT_NETRC_FILE, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_NEW_DIRECTORY_PERMS", CURLOPT_NEW_DIRECTORY_PERMS, CURLOPTTYPE_LONG},
+  {"CURLOPT_NEW_FILE_PERMS", CURLOPT_NEW_FILE_PERMS, CURLOPTTYPE_LONG},
+  {"CURLOPT_NOBODY", CURLOPT_NOBODY, CURLOPTTYPE_LONG},
+  {"CURLOPT_NOPROGRESS", CURLOPT_NOPROGRESS, CURLOPTTYPE_LONG},
+  {"CURLOPT_NOPROXY", CURLOPT_NOPROXY, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_NOSIGNAL", CURLOPT_NOSIGNAL, CURLOPTTYPE_LONG},
+  {"CURLOPT_PATH_AS_IS", CURLOPT_PATH_AS_IS, CURLOPTTYPE_LONG},
+  {"CURLOPT_PINNEDPUBLICKEY", CURLOPT_PINNEDPUBLICKEY, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_PIPEWAIT", CURLOPT_PIPEWAIT, CURLOPTTYPE_LONG},
+  {"CURLOPT_PORT", CURLOPT_PORT, CURLOPTTYPE_LONG},
+  {"CURLOPT_POST", CURLOPT_POST, CURLOPTTYPE_LONG},
+  {"CURLOPT_POSTFIELDS", CURLOPT_POSTFIELDS, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_POSTFIELDSIZE", CURLOPT_POSTFIELDSIZE, CURLOPTTYPE_LONG},
+  {"CURLOPT_POSTFIELDSIZE_LARGE", CURLOPT_POSTFIELDSIZE_LARGE, CURLOPTTYPE_OFF_T},
+  {"CURLOPT_PROTOCOLS", CURLOPT_PROTOCOLS, CURLOPTTYPE_LONG},
+  {"CURLOPT_PROXY", CURLOPT_PROXY, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_PROXYAUTH", CURLOPT_PROXYAUTH, CURLOPTTYPE_LONG},
+  {"CURLOPT_PROXYPASSWORD", CURLOPT_PROXYPASSWORD, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_PROXYPORT", CURLOPT_PROXYPORT, CURLOPTTYPE_LONG},
+  {"CURLOPT_PROXYTYPE", CURLOPT_PROXYTYPE, CURLOPTTYPE_LONG},
+  {"CURLOPT_PROXYUSERNAME", CURLOPT_PROXYUSERNAME, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_PROXYUSERPWD", CURLOPT_PROXYUSERPWD, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_PUT", CURLOPT_PUT, CURLOPTTYPE_LONG},
+  {"CURLOPT_RANDOM_FILE", CURLOPT_RANDOM_FILE, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_RANGE", CURLOPT_RANGE, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_REDIR_PROTOCOLS", CURLOPT_REDIR_PROTOCOLS, CURLOPTTYPE_LONG},
+  {"CURLOPT_RESUME_FROM", CURLOPT_RESUME_FROM, CURLOPTTYPE_LONG},
+  {"CURLOPT_RESUME_FROM_LARGE", CURLOPT_RESUME_FROM_LARGE, CURLOPTTYPE_OFF_T},
+  {"CURLOPT_RTSP_CLIENT_CSEQ", CURLOPT_RTSP_CLIENT_CSEQ, CURLOPTTYPE_LONG},
+  {"CURLOPT_RTSP_REQUEST", CURLOPT_RTSP_REQUEST, CURLOPTTYPE_LONG},
+  {"CURLOPT_RTSP_SERVER_CSEQ", CURLOPT_RTSP_SERVER_CSEQ, CURLOPTTYPE_LONG},
+  {"CURLOPT_RTSP_SESSION_ID", CURLOPT_RTSP_SESSION_ID, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_RTSP_STREAM_URI", CURLOPT_RTSP_STREAM_URI, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_RTSP_TRANSPORT", CURLOPT_RTSP_TRANSPORT, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_SASL_IR", CURLOPT_SASL_IR, CURLOPTTYPE_LONG},
+  {"CURLOPT_SOCKS5_GSSAPI_NEC", CURLOPT_SOCKS5_GSSAPI_NEC, CURLOPTTYPE_LONG},
+  {"CURLOPT_SOCKS5_GSSAPI_SERVICE", CURLOPT_SOCKS5_GSSAPI_SERVICE, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_SSH_AUTH_TYPES", CURLOPT_SSH_AUTH_TYPES, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_SSH_COMPRESSION", CURLOPT_SSH_COMPRESSION, CURLOPTTYPE_LONG},
+  {"CURLOPT_SSH_HOST_PUBLIC_KEY_MD5", CURLOPT_SSH_HOST_PUBLIC_KEY_MD5, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_SSH_KNOWNHOSTS", CURLOPT_SSH_KNOWNHOSTS, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_SSH_PRIVATE_KEYFILE", CURLOPT_SSH_PRIVATE_KEYFILE, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_SSH_PUBLIC_KEYFILE", CURLOPT_SSH_PUBLIC_KEYFILE, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_SSLCERT", CURLOPT_SSLCERT, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_SSLCERTTYPE", CURLOPT_SSLCERTTYPE, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_SSL_CIPHER_LIST", CURLOPT_SSL_CIPHER_LIST, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_SSLENGINE", CURLOPT_SSLENGINE, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_SSLENGINE_DEFAULT", CURLOPT_SSLENGINE_DEFAULT, CURLOPTTYPE_LONG},
+  {"CURLOPT_SSLKEY", CURLOPT_SSLKEY, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_SSLKEYTYPE", CURLOPT_SSLKEYTYPE, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_SSLVERSION", CURLOPT_SSLVERSION, CURLOPTTYPE_LONG},
+  {"CURLOPT_SSL_OPTIONS", CURLOPT_SSL_OPTIONS, CURLOPTTYPE_LONG},
+  {"CURLOPT_SSL_SESSIONID_CACHE", CURLOPT_SSL_SESSIONID_CACHE, CURLOPTTYPE_LONG},
+  {"CURLOPT_SSL_VERIFYHOST", CURLOPT_SSL_VERIFYHOST, CURLOPTTYPE_LONG},
+  {"CURLOPT_SSL_VERIFYPEER", CURLOPT_SSL_VERIFYPEER, CURLOPTTYPE_LONG},
+  {"CURLOPT_SSL_VERIFYSTATUS", CURLOPT_SSL_VERIFYSTATUS, CURLOPTTYPE_LONG},
+  {"CURLOPT_TCP_FASTOPEN", CURLOPT_TCP_FASTOPEN, CURLOPTTYPE_LONG},
+  {"CURLOPT_TCP_KEEPALIVE", CURLOPT_TCP_KEEPALIVE, CURLOPTTYPE_LONG},
+  {"CURLOPT_TCP_KEEPIDLE", CURLOPT_TCP_KEEPIDLE, CURLOPTTYPE_LONG},
+  {"CURLOPT_TCP_KEEPINTVL", CURLOPT_TCP_KEEPINTVL, CURLOPTTYPE_LONG},
+  {"CURLOPT_TCP_NODELAY", CURLOPT_TCP_NODELAY, CURLOPTTYPE_LONG},
+  {"CURLOPT_TFTP_BLKSIZE", CURLOPT_TFTP_BLKSIZE, CURLOPTTYPE_LONG},
+  {"CURLOPT_TFTP_NO_OPTIONS", CURLOPT_TFTP_NO_OPTIONS, CURLOPTTYPE_LONG},
+  {"CURLOPT_TIMECONDITION", CURLOPT_TIMECONDITION, CURLOPTTYPE_LONG},
+  {"CURLOPT_TIMEOUT", CURLOPT_TIMEOUT, CURLOPTTYPE_LONG},
+  {"CURLOPT_TIMEOUT_MS", CURLOPT_TIMEOUT_MS, CURLOPTTYPE_LONG},
+  {"CURLOPT_TIMEVALUE", CURLOPT_TIMEVALUE, CURLOPTTYPE_LONG},
+  {"CURLOPT_TLSAUTH_PASSWORD", CURLOPT_TLSAUTH_PASSWORD, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_TLSAUTH_TYPE", CURLOPT_TLSAUTH_TYPE, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_TLSAUTH_USERNAME", CURLOPT_TLSAUTH_USERNAME, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_TRANSFERTEXT", CURLOPT_TRANSFERTEXT, CURLOPTTYPE_LONG},
+  {"CURLOPT_UNIX_SOCKET_PATH", CURLOPT_UNIX_SOCKET_PATH, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_UNRESTRICTED_AUTH", CURLOPT_UNRESTRICTED_AUTH, CURLOPTTYPE_LONG},
+  {"CURLOPT_UPLOAD", CURLOPT_UPLOAD, CURLOPTTYPE_LONG},
+  {"CURLOPT_URL", CURLOPT_URL, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_USERAGENT", CURLOPT_USERAGENT, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_USERNAME", CURLOPT_USERNAME, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_USERPWD", CURLOPT_USERPWD, CURLOPTTYPE_STRINGPOINT},
+  {"CURLOPT_USE_SSL", CURLOPT_USE_SSL, CURLOPTTYPE_LONG},
+  {"CURLOPT_VERBOSE", CURLOPT_VERBOSE, CURLOPTTYPE_LONG},
+  {"CURLOPT_WILDCARDMATCH", CURLOPT_WILDCARDMATCH, CURLOPTTYPE_LONG}
 };
+static constexpr size_t curl_options_count = sizeof(curl_options_available) / sizeof(curl_options_available[0]);
+
+// hash an option name with given seed, fnv-1a is followed by murmur finalizer so each seed gives an independent hash
+constexpr uint32_t curl_option_hash(std::string_view name, uint32_t seed) {
+  uint32_t hash = 2166136261u ^ seed;
+  for (char c : name) {
+    hash = (hash ^ (unsigned char)c) * 16777619u;
+  }
+
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6bu;
+  hash ^= hash >> 13;
+  hash *= 0xc2b2ae35u;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+// define a perfect hash of option names built at compile time by hash and displace
+// names are distributed to buckets by a first hash, each bucket gets a seed placing all of its names into free slots
+struct curl_option_index {
+  static constexpr size_t buckets = 64;
+  static constexpr size_t slots = 256;
+  static constexpr size_t max_bucket_size = 16;
+
+  uint32_t seeds[buckets] = {};
+  int16_t entries[slots] = {};
+  bool complete = false;
+};
+
+constexpr curl_option_index build_curl_option_index() {
+  curl_option_index index;
+  for (auto &entry : index.entries) {
+    entry = -1;
+  }
+
+  // group options by bucket with a counting sort
+  size_t bucket_start[curl_option_index::buckets + 1] = {};
+  for (auto &definition : curl_options_available) {
+    bucket_start[curl_option_hash(definition.name, 0) % curl_option_index::buckets + 1]++;
+  }
+  for (size_t bucket = 0; bucket < curl_option_index::buckets; bucket++) {
+    bucket_start[bucket + 1] += bucket_start[bucket];
+  }
+
+  size_t members[curl_options_count] = {};
+  size_t filled[curl_option_index::buckets] = {};
+  for (size_t i = 0; i < curl_options_count; i++) {
+    size_t bucket = curl_option_hash(curl_options_available[i].name, 0) % curl_option_index::buckets;
+    members[bucket_start[bucket] + filled[bucket]++] = i;
+  }
+
+  // place largest buckets first while most slots are free
+  for (size_t size = curl_option_index::max_bucket_size; size > 0; size--) {
+    for (size_t bucket = 0; bucket < curl_option_index::buckets; bucket++) {
+      if (filled[bucket] != size) {
+        continue;
+      }
+
+      bool placed = false;
+      for (uint32_t seed = 1; seed < 100000 && !placed; seed++) {
+        size_t candidates[curl_option_index::max_bucket_size] = {};
+        bool free = true;
+
+        for (size_t k = 0; k < size && free; k++) {
+          size_t slot = curl_option_hash(curl_options_available[members[bucket_start[bucket] + k]].name, seed) % curl_option_index::slots;
+          free = index.entries[slot] < 0;
+          for (size_t j = 0; j < k && free; j++) {
+            free = candidates[j] != slot;
+          }
+          candidates[k] = slot;
+        }
+
+        if (free) {
+          for (size_t k = 0; k < size; k++) {
+            index.entries[candidates[k]] = (int16_t)members[bucket_start[bucket] + k];
+          }
+          index.seeds[bucket] = seed;
+          placed = true;
+        }
+      }
+
+      if (!placed) {
+        return index;
+      }
+    }
+  }
+
+  // a bucket larger than supported is left unplaced
+  for (size_t bucket = 0; bucket < curl_option_index::buckets; bucket++) {
+    if (filled[bucket] > curl_option_index::max_bucket_size) {
+      return index;
+    }
+  }
+
+  index.complete = true;
+  return index;
+}
+
+static constexpr curl_option_index curl_options_index = build_curl_option_index();
+static_assert(curl_options_index.complete, "failed to build perfect hash of curl options");
+
+// find a supported curl option by name with two hashes and a single comparison
+static const curl_option_definition *find_curl_option(std::string_view name) {
+  uint32_t seed = curl_options_index.seeds[curl_option_hash(name, 0) % curl_option_index::buckets];
+  int16_t entry = curl_options_index.entries[curl_option_hash(name, seed) % curl_option_index::slots];
+  return entry >= 0 && curl_options_available[entry].name == name ? &curl_options_available[entry] : nullptr;
+}
 
 // define a udf management class to configure functions
 class udf_manager {
@@ -206,6 +631,7 @@ class udf_manager {
 
   private:
     string_list set;
+    string_list aggregate_set;
 
   public:
     ~udf_manager() { 
@@ -224,6 +650,18 @@ class udf_manager {
       return false;
     }
 
+    // register given aggregate function
+    bool register_aggregate_function(const char *func_name, enum Item_result return_type, Udf_func_any func, Udf_func_init init_func, Udf_func_deinit deinit_func, Udf_func_add add_func, Udf_func_clear clear_func) {
+      if (!mysql_service_udf_registration_aggregate->udf_register(func_name, return_type, func, init_func, deinit_func, add_func, clear_func)) {
+        aggregate_set.push_back(func_name);
+
+        // registration is successful
+        return true;
+      }
+
+      return false;
+    }
+
     // unregister all previously registered functions in this component
     bool unregister_all_functions() {
       string_list delete_set;
@@ -235,69 +673,4495 @@ class udf_manager {
         }
       }
 
-      for (auto udf : delete_set) {
-        set.remove(udf);
-      }
+      for (auto udf : delete_set) {
+        set.remove(udf);
+      }
+
+      delete_set.clear();
+      for (auto udf : aggregate_set) {
+        int was_present = 0;
+        if (!mysql_service_udf_registration_aggregate->udf_unregister(udf.c_str(), &was_present) || !was_present) {
+          delete_set.push_back(udf);
+        }
+      }
+
+      for (auto udf : delete_set) {
+        aggregate_set.remove(udf);
+      }
+
+      // successful if list of functions is empty
+      if (set.empty() && aggregate_set.empty()) {
+        return true;
+      }
+
+      return false;
+    }
+
+};
+udf_manager *my_udf_manager;
+
+// define a bounded pool of reusable curl handles sharing connections, dns cache and tls sessions
+class curl_handle_pool {
+  private:
+    CURLSH *share = nullptr;
+    std::mutex share_locks[CURL_LOCK_DATA_LAST];
+    std::mutex idle_lock;
+    std::vector<CURL *> idle;
+
+    static void lock_share(CURL *, curl_lock_data data, curl_lock_access, void *userp) {
+      static_cast<curl_handle_pool *>(userp)->share_locks[data].lock();
+    }
+
+    static void unlock_share(CURL *, curl_lock_data data, void *userp) {
+      static_cast<curl_handle_pool *>(userp)->share_locks[data].unlock();
+    }
+
+  public:
+    curl_handle_pool() {
+      share = curl_share_init();
+      if (share == nullptr) {
+        LogComponentErr(WARNING_LEVEL, ER_LOG_PRINTF_MSG, "failed to create curl share, connections will not be shared");
+        return;
+      }
+
+      curl_share_setopt(share, CURLSHOPT_LOCKFUNC, lock_share);
+      curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, unlock_share);
+      curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+      curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+      curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+      curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    }
+
+    ~curl_handle_pool() {
+      // handles must be cleaned up before the share they are attached to
+      for (auto curl : idle) {
+        curl_easy_cleanup(curl);
+      }
+      idle.clear();
+
+      if (share != nullptr) {
+        curl_share_cleanup(share);
+      }
+    }
+
+    // get an idle handle or create a new one if pool is empty
+    CURL *acquire() {
+      {
+        std::lock_guard<std::mutex> guard(idle_lock);
+        if (!idle.empty()) {
+          CURL *curl = idle.back();
+          idle.pop_back();
+          return curl;
+        }
+      }
+
+      CURL *curl = curl_easy_init();
+      if (curl != nullptr) {
+        reset(curl);
+      }
+      return curl;
+    }
+
+    // give the handle back to pool, handles exceeding pool size are destroyed
+    void release(CURL *curl) {
+      if (curl == nullptr) {
+        return;
+      }
+
+      // reset keeps live connections, dns and tls session caches of the handle
+      reset(curl);
+
+      {
+        std::lock_guard<std::mutex> guard(idle_lock);
+        if (idle.size() < connection_pool_size) {
+          idle.push_back(curl);
+          return;
+        }
+      }
+
+      curl_easy_cleanup(curl);
+    }
+
+  private:
+    void reset(CURL *curl) {
+      curl_easy_reset(curl);
+
+      // signals are not safe in a multi-threaded server
+      curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+      if (share != nullptr) {
+        curl_easy_setopt(curl, CURLOPT_SHARE, share);
+
+        // curl trims the shared connection cache to 5 connections after each transfer by default
+        curl_easy_setopt(curl, CURLOPT_MAXCONNECTS, (long)std::max(connection_pool_size, 5U));
+      }
+    }
+};
+curl_handle_pool *my_curl_handle_pool;
+
+// borrow a pooled curl handle for the lifetime of a request
+class pooled_curl_handle {
+  private:
+    curl_handle_pool *pool;
+    CURL *curl;
+
+  public:
+    explicit pooled_curl_handle(curl_handle_pool *handle_pool = my_curl_handle_pool) : pool(handle_pool), curl(handle_pool->acquire()) {}
+
+    ~pooled_curl_handle() {
+      pool->release(curl);
+    }
+
+    pooled_curl_handle(const pooled_curl_handle &) = delete;
+    pooled_curl_handle &operator=(const pooled_curl_handle &) = delete;
+
+    CURL *get() const {
+      return curl;
+    }
+};
+
+// define a bounded lock-free multi producer multi consumer queue
+template <typename T>
+class bounded_queue {
+  private:
+    struct cell {
+      std::atomic<size_t> sequence;
+      T data;
+    };
+
+    std::unique_ptr<cell[]> buffer;
+    size_t mask;
+    alignas(64) std::atomic<size_t> enqueue_pos{0};
+    alignas(64) std::atomic<size_t> dequeue_pos{0};
+
+  public:
+    // capacity is rounded up to a power of two
+    explicit bounded_queue(size_t capacity) {
+      size_t size = 2;
+      while (size < capacity) {
+        size <<= 1;
+      }
+
+      buffer.reset(new cell[size]);
+      mask = size - 1;
+      for (size_t i = 0; i < size; i++) {
+        buffer[i].sequence.store(i, std::memory_order_relaxed);
+      }
+    }
+
+    bool push(const T &data) {
+      size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+      while (true) {
+        cell *c = &buffer[pos & mask];
+        size_t sequence = c->sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+
+        if (diff == 0) {
+          if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            c->data = data;
+            c->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+          }
+        }
+        else if (diff < 0) {
+          // queue is full
+          return false;
+        }
+        else {
+          pos = enqueue_pos.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    bool pop(T &data) {
+      size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+      while (true) {
+        cell *c = &buffer[pos & mask];
+        size_t sequence = c->sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+
+        if (diff == 0) {
+          if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+            data = c->data;
+            c->sequence.store(pos + mask + 1, std::memory_order_release);
+            return true;
+          }
+        }
+        else if (diff < 0) {
+          // queue is empty
+          return false;
+        }
+        else {
+          pos = dequeue_pos.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    // approximate number of queued items
+    size_t size() const {
+      size_t enqueued = enqueue_pos.load(std::memory_order_relaxed);
+      size_t dequeued = dequeue_pos.load(std::memory_order_relaxed);
+      return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    bool empty() const {
+      return size() == 0;
+    }
+};
+
+// define result of a request sent by http_request_async
+struct async_response {
+  bool pending = true;
+  long status = 0;
+  std::string body;
+};
+
+// keep async responses until they expire or are evicted by the memory limit
+class async_response_store {
+  private:
+    static const size_t SHARDS = 16;
+
+    struct shard {
+      std::mutex lock;
+      std::unordered_map<unsigned long long, async_response> responses;
+      // ids of completed responses in completion order, oldest first
+      std::deque<std::pair<unsigned long long, std::chrono::steady_clock::time_point>> completed;
+      size_t memory_used = 0;
+    };
+
+    shard shards[SHARDS];
+    std::atomic<unsigned long long> next_id{1};
+
+    shard &shard_of(unsigned long long id) {
+      return shards[id % SHARDS];
+    }
+
+    // remove oldest completed response of the shard, shard must be locked
+    void evict_oldest(shard &s) {
+      auto id = s.completed.front().first;
+      s.completed.pop_front();
+
+      auto it = s.responses.find(id);
+      if (it != s.responses.end()) {
+        s.memory_used -= it->second.body.size();
+        async_memory_used -= it->second.body.size();
+        s.responses.erase(it);
+      }
+    }
+
+  public:
+    // reserve an id for a pending request
+    unsigned long long create() {
+      auto id = next_id++;
+      shard &s = shard_of(id);
+      std::lock_guard<std::mutex> guard(s.lock);
+      s.responses.emplace(id, async_response());
+      return id;
+    }
+
+    // forget a request which could not be queued
+    void remove(unsigned long long id) {
+      shard &s = shard_of(id);
+      std::lock_guard<std::mutex> guard(s.lock);
+      s.responses.erase(id);
+    }
+
+    // store response of a finished request, evicting oldest responses above memory limit
+    void complete(unsigned long long id, long status, std::string &&body) {
+      shard &s = shard_of(id);
+      std::lock_guard<std::mutex> guard(s.lock);
+
+      auto it = s.responses.find(id);
+      if (it == s.responses.end()) {
+        return;
+      }
+
+      it->second.pending = false;
+      it->second.status = status;
+      it->second.body = std::move(body);
+      s.memory_used += it->second.body.size();
+      async_memory_used += it->second.body.size();
+      s.completed.emplace_back(id, std::chrono::steady_clock::now());
+
+      while (s.memory_used > async_memory_limit / SHARDS && !s.completed.empty()) {
+        evict_oldest(s);
+        async_evicted++;
+      }
+    }
+
+    // get a completed response, returns false if it is pending or unknown
+    bool get(unsigned long long id, long *status, std::string *body) {
+      shard &s = shard_of(id);
+      std::lock_guard<std::mutex> guard(s.lock);
+
+      auto it = s.responses.find(id);
+      if (it == s.responses.end() || it->second.pending) {
+        return false;
+      }
+
+      *status = it->second.status;
+      if (body != nullptr) {
+        *body = it->second.body;
+      }
+      return true;
+    }
+
+    // remove completed responses older than ttl
+    void expire() {
+      auto deadline = std::chrono::steady_clock::now() - std::chrono::seconds(async_response_ttl);
+
+      for (auto &s : shards) {
+        std::lock_guard<std::mutex> guard(s.lock);
+        while (!s.completed.empty() && s.completed.front().second < deadline) {
+          evict_oldest(s);
+        }
+      }
+    }
+};
+async_response_store *my_async_response_store;
+
+// define a response kept in response cache
+struct cached_response {
+  std::string url;
+  std::string body;
+  std::string etag;
+  std::string last_modified;
+  std::chrono::steady_clock::time_point expires_at;
+};
+
+// keep responses of GET requests in a memory bounded lru cache sharded by key hash
+class response_cache {
+  private:
+    static const size_t SHARDS = 16;
+
+    typedef std::list<std::pair<std::string, cached_response>> entry_list;
+
+    struct shard {
+      std::mutex lock;
+      // most recently used entries first
+      entry_list entries;
+      std::unordered_map<std::string, entry_list::iterator> index;
+      size_t memory_used = 0;
+    };
+
+    shard shards[SHARDS];
+
+    shard &shard_of(const std::string &key) {
+      return shards[std::hash<std::string>()(key) % SHARDS];
+    }
+
+    static size_t memory_of(const std::string &key, const cached_response &response) {
+      return key.size() + response.url.size() + response.body.size() + response.etag.size() + response.last_modified.size() + 128;
+    }
+
+    // remove given entry, shard must be locked
+    void erase(shard &s, entry_list::iterator it) {
+      auto size = memory_of(it->first, it->second);
+      s.memory_used -= size;
+      cache_bytes -= size;
+      s.index.erase(it->first);
+      s.entries.erase(it);
+    }
+
+  public:
+    // copy cached response of given key, fresh is set if it can be used without revalidation
+    bool get(const std::string &key, cached_response &response, bool *fresh) {
+      shard &s = shard_of(key);
+      std::lock_guard<std::mutex> guard(s.lock);
+
+      auto it = s.index.find(key);
+      if (it == s.index.end()) {
+        return false;
+      }
+
+      s.entries.splice(s.entries.begin(), s.entries, it->second);
+      response = it->second->second;
+      *fresh = std::chrono::steady_clock::now() < response.expires_at;
+      return true;
+    }
+
+    // store response of given key and evict least recently used entries above memory limit
+    void put(const std::string &key, cached_response &&response) {
+      shard &s = shard_of(key);
+      std::lock_guard<std::mutex> guard(s.lock);
+
+      auto it = s.index.find(key);
+      if (it != s.index.end()) {
+        erase(s, it->second);
+      }
+
+      auto size = memory_of(key, response);
+      if (size > cache_size / SHARDS) {
+        return;
+      }
+
+      s.entries.emplace_front(key, std::move(response));
+      s.index[key] = s.entries.begin();
+      s.memory_used += size;
+      cache_bytes += size;
+
+      while (s.memory_used > cache_size / SHARDS) {
+        erase(s, std::prev(s.entries.end()));
+        cache_evictions++;
+      }
+    }
+
+    // extend freshness of a revalidated response
+    void refresh(const std::string &key, std::chrono::steady_clock::time_point expires_at) {
+      shard &s = shard_of(key);
+      std::lock_guard<std::mutex> guard(s.lock);
+
+      auto it = s.index.find(key);
+      if (it != s.index.end()) {
+        it->second->second.expires_at = expires_at;
+      }
+    }
+
+    // remove all responses of urls starting with given prefix
+    unsigned long long invalidate(const std::string &prefix) {
+      unsigned long long count = 0;
+
+      for (auto &s : shards) {
+        std::lock_guard<std::mutex> guard(s.lock);
+        for (auto it = s.entries.begin(); it != s.entries.end();) {
+          auto next = std::next(it);
+          if (it->second.url.compare(0, prefix.size(), prefix) == 0) {
+            erase(s, it);
+            count++;
+          }
+          it = next;
+        }
+      }
+
+      return count;
+    }
+};
+response_cache *my_response_cache;
+
+// define a request in flight whose response is shared with identical requests waiting for it
+struct coalesced_flight {
+  std::mutex lock;
+  std::condition_variable finished_signal;
+  bool finished = false;
+  bool succeeded = false;
+  std::string body;
+
+  // requests waiting for this one, guarded by the lock of its shard
+  size_t followers = 0;
+};
+
+// keep identical requests in flight so concurrent requests wait for a single transfer, nothing is kept after it finishes
+class request_coalescer {
+  private:
+    static const size_t SHARDS = 16;
+
+    struct shard {
+      std::mutex lock;
+      std::unordered_map<std::string, std::shared_ptr<coalesced_flight>> flights;
+    };
+
+    shard shards[SHARDS];
+
+    shard &shard_of(const std::string &key) {
+      return shards[std::hash<std::string>()(key) % SHARDS];
+    }
+
+  public:
+    // join the flight of given key or start a new one, leader is set if the caller has to send the request
+    std::shared_ptr<coalesced_flight> join(const std::string &key, bool &leader) {
+      shard &s = shard_of(key);
+      std::lock_guard<std::mutex> guard(s.lock);
+
+      auto &flight = s.flights[key];
+      leader = flight == nullptr;
+      if (leader) {
+        flight = std::make_shared<coalesced_flight>();
+      }
+      else {
+        flight->followers++;
+      }
+      return flight;
+    }
+
+    // end a flight and wake up its followers, a null body makes them send their own requests
+    // the body is only copied if someone is waiting for it
+    void finish(const std::string &key, const std::shared_ptr<coalesced_flight> &flight, const char *body, size_t body_length) {
+      size_t followers;
+      {
+        shard &s = shard_of(key);
+        std::lock_guard<std::mutex> guard(s.lock);
+        auto it = s.flights.find(key);
+        if (it != s.flights.end() && it->second == flight) {
+          s.flights.erase(it);
+        }
+        followers = flight->followers;
+      }
+
+      std::lock_guard<std::mutex> guard(flight->lock);
+      if (body != nullptr && followers > 0) {
+        flight->body.assign(body, body_length);
+        flight->succeeded = true;
+      }
+      flight->finished = true;
+      flight->finished_signal.notify_all();
+    }
+
+    // wait for the leader of a flight, returns false if it failed or did not finish in time
+    bool wait(const std::shared_ptr<coalesced_flight> &flight, long timeout_ms) {
+      std::unique_lock<std::mutex> guard(flight->lock);
+      flight->finished_signal.wait_for(guard, std::chrono::milliseconds(timeout_ms), [&flight]() { return flight->finished; });
+      return flight->finished && flight->succeeded;
+    }
+};
+request_coalescer *my_request_coalescer;
+
+// define metadata of a request kept in history of recent requests
+struct request_record {
+  unsigned long long timestamp_us;
+  // connection id of the caller, 0 for requests sent by background thread
+  unsigned long long thread_id;
+  char method[16];
+  unsigned int method_length;
+  char host[256];
+  unsigned int host_length;
+  long status;
+  int curl_code;
+  unsigned long long bytes_sent;
+  unsigned long long bytes_received;
+  unsigned long long dns_us;
+  unsigned long long connect_us;
+  unsigned long long tls_us;
+  unsigned long long ttfb_us;
+  unsigned long long total_us;
+  bool cache_hit;
+  bool connection_reused;
+};
+
+// keep recent requests in a fixed size ring, writers never block and overwrite oldest records
+class request_history {
+  private:
+    // sequence is odd while a record is written and 2 * (position + 1) once it is complete
+    struct alignas(64) slot {
+      std::atomic<unsigned long long> sequence{0};
+      request_record record;
+    };
+
+    std::unique_ptr<slot[]> slots;
+    size_t size;
+    std::atomic<unsigned long long> head{0};
+
+  public:
+    explicit request_history(size_t size) : slots(size > 0 ? new slot[size] : nullptr), size(size) {
+    }
+
+    void add(const request_record &record) {
+      if (size == 0) {
+        return;
+      }
+
+      auto position = head.fetch_add(1, std::memory_order_relaxed);
+      slot &s = slots[position % size];
+
+      // a slot still being written by a lapped writer is skipped instead of waited for
+      auto sequence = s.sequence.load(std::memory_order_relaxed);
+      if ((sequence & 1) || !s.sequence.compare_exchange_strong(sequence, 2 * position + 1, std::memory_order_acquire)) {
+        return;
+      }
+
+      std::atomic_thread_fence(std::memory_order_release);
+      s.record = record;
+      s.sequence.store(2 * (position + 1), std::memory_order_release);
+    }
+
+    // copy record of given position, false if it is not written yet or already overwritten
+    bool read(unsigned long long position, request_record &record) const {
+      const slot &s = slots[position % size];
+      auto sequence = s.sequence.load(std::memory_order_acquire);
+      if (sequence != 2 * (position + 1)) {
+        return false;
+      }
+
+      record = s.record;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      return s.sequence.load(std::memory_order_relaxed) == sequence;
+    }
+
+    // return range of positions that may still be in the ring
+    unsigned long long begin() const {
+      auto end_position = end();
+      return end_position > size ? end_position - size : 0;
+    }
+
+    unsigned long long end() const {
+      return head.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const {
+      return size;
+    }
+};
+request_history *my_request_history;
+
+// define a request log entry, message is formatted by logger thread only when it is written
+struct log_record {
+  loglevel level;
+  std::string method;
+  std::string url;
+  long status = 0;
+  CURLcode res = CURLE_OK;
+  unsigned long long elapsed_ms = 0;
+
+  // preformatted message of errors not belonging to a transfer
+  std::string message;
+};
+
+// write request logs to error log from a component owned thread, so requests never wait for log i/o
+class request_logger {
+  private:
+    static const size_t QUEUE_SIZE = 4096;
+    static const size_t BATCH_SIZE = 256;
+
+    bounded_queue<log_record *> queue;
+    std::thread thread;
+    std::mutex lock;
+    std::condition_variable records_available;
+    std::atomic<bool> running{false};
+
+    static std::string format(const log_record &record) {
+      if (!record.message.empty()) {
+        return record.message;
+      }
+
+      std::string elapsed = " (" + std::to_string(record.elapsed_ms) + " ms)";
+      if (record.res != CURLE_OK) {
+        return record.method + " " + record.url + " failed with error code " + std::to_string(record.status) + ": " + curl_easy_strerror(record.res) + elapsed;
+      }
+      return record.method + " " + record.url + " returned status code " + std::to_string(record.status) + elapsed;
+    }
+
+    // write queued records in batches, returns false once the queue is empty
+    bool drain() {
+      log_record *record = nullptr;
+      for (size_t i = 0; i < BATCH_SIZE; i++) {
+        if (!queue.pop(record)) {
+          return false;
+        }
+
+        std::string msg = format(*record);
+        LogComponentErr(record->level, ER_LOG_PRINTF_MSG, msg.c_str());
+        delete record;
+      }
+      return true;
+    }
+
+    void run() {
+      while (running.load(std::memory_order_relaxed)) {
+        if (!drain()) {
+          std::unique_lock<std::mutex> guard(lock);
+          records_available.wait_for(guard, std::chrono::seconds(1));
+        }
+      }
+
+      // write everything queued before stop
+      while (drain()) {
+      }
+    }
+
+  public:
+    request_logger() : queue(QUEUE_SIZE) {
+    }
+
+    ~request_logger() {
+      stop();
+    }
+
+    void start() {
+      running = true;
+      thread = std::thread(&request_logger::run, this);
+    }
+
+    void stop() {
+      if (!thread.joinable()) {
+        return;
+      }
+
+      running = false;
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        records_available.notify_all();
+      }
+      thread.join();
+    }
+
+    // queue a record without blocking, records are dropped when the queue is full
+    void log(log_record *record) {
+      if (!queue.push(record)) {
+        delete record;
+        log_dropped++;
+        return;
+      }
+      records_available.notify_one();
+    }
+};
+request_logger *my_request_logger;
+
+// define limits and circuit breaker of a single host
+struct host_state {
+  enum breaker_states { CLOSED, OPEN, HALF_OPEN };
+
+  std::mutex lock;
+  std::condition_variable slot_available;
+  unsigned int in_flight = 0;
+
+  // per host limits set by http_host_limit, -1 uses the system variable
+  long max_in_flight = -1;
+  long rate_limit = -1;
+
+  // token bucket refilled by rate limit per second, negative tokens are reserved by waiting requests
+  double tokens = 0;
+  std::chrono::steady_clock::time_point refilled_at = std::chrono::steady_clock::now();
+
+  breaker_states breaker = CLOSED;
+  unsigned int failures = 0;
+  bool probe_in_flight = false;
+  std::chrono::steady_clock::time_point opened_at;
+};
+
+// keep state of hosts, states are never removed since hosts called from sql are a small set
+class host_registry {
+  private:
+    std::mutex lock;
+    std::unordered_map<std::string, std::shared_ptr<host_state>> hosts;
+    std::atomic<unsigned long> overrides{0};
+
+  public:
+    std::shared_ptr<host_state> get(const std::string &host) {
+      std::lock_guard<std::mutex> guard(lock);
+      auto &state = hosts[host];
+      if (state == nullptr) {
+        state = std::make_shared<host_state>();
+      }
+      return state;
+    }
+
+    // set limits of a single host, negative values use system variables
+    void set_limits(const std::string &host, long max_in_flight, long rate_limit) {
+      auto state = get(host);
+      std::lock_guard<std::mutex> guard(state->lock);
+      if ((state->max_in_flight >= 0 || state->rate_limit >= 0) != (max_in_flight >= 0 || rate_limit >= 0)) {
+        max_in_flight >= 0 || rate_limit >= 0 ? overrides++ : overrides--;
+      }
+      state->max_in_flight = max_in_flight;
+      state->rate_limit = rate_limit;
+      state->slot_available.notify_all();
+    }
+
+    // check if any limit or breaker applies, so unlimited requests skip the registry
+    bool enabled() const {
+      return host_max_in_flight > 0 || host_rate_limit > 0 || breaker_failure_threshold > 0 || overrides.load(std::memory_order_relaxed) > 0;
+    }
+
+    // list hosts with a breaker which is not closed
+    std::string breaker_state() {
+      std::string value;
+      std::lock_guard<std::mutex> guard(lock);
+      for (auto &item : hosts) {
+        std::lock_guard<std::mutex> state_guard(item.second->lock);
+        if (item.second->breaker != host_state::CLOSED) {
+          value += (value.empty() ? "" : ",") + item.first + ":" + (item.second->breaker == host_state::OPEN ? "OPEN" : "HALF_OPEN");
+        }
+      }
+      return value;
+    }
+};
+host_registry *my_host_registry;
+
+namespace udf_impl {
+  // define a curl option resolved from CURL_OPTIONS argument
+  struct compiled_curl_option {
+    CURLoption option;
+    long type;
+    long long_value;
+    curl_off_t off_value;
+    std::string string_value;
+  };
+
+  // define a curl header list resolved from HEADERS argument
+  struct compiled_headers {
+    struct curl_slist *list = nullptr;
+
+    compiled_headers() = default;
+    compiled_headers(const compiled_headers &) = delete;
+    compiled_headers &operator=(const compiled_headers &) = delete;
+
+    ~compiled_headers() {
+      curl_slist_free_all(list);
+    }
+  };
+
+  // define encodings of compressed request bodies
+  enum compressions { COMPRESSION_NONE, COMPRESSION_GZIP, COMPRESSION_ZSTD };
+
+  // define component settings given as HTTPCLIENT_* keys of CURL_OPTIONS argument
+  struct request_options {
+    // decode compressed responses on the fly, -1 follows httpclient.accept_encoding
+    int decode = -1;
+
+    // compress request bodies of at least httpclient.compress_min_size bytes
+    compressions compress = COMPRESSION_NONE;
+
+    // compression level, 0 uses default level of the encoding
+    int compress_level = 0;
+
+    // flush files written by http_request_to_file to disk before returning
+    bool fsync = false;
+
+    // number of retries after connect errors, 502, 503, 504 and 429 responses with retry-after
+    long retries = 0;
+
+    // base delay of exponential backoff between retries
+    long retry_backoff_ms = 100;
+
+    // time limit of all attempts together, 0 is unlimited
+    long deadline_ms = 0;
+
+    // delay before a duplicate GET request is sent, 0 disables hedging and -1 uses observed p95 latency
+    long hedge_ms = 0;
+
+    // send the body with chunked transfer encoding from a read callback instead of a content length
+    bool chunked = false;
+
+    // time an identical GET request in flight is waited for instead of sending another one, 0 disables coalescing
+    long coalesce_ms = 0;
+  };
+
+  // define request parts compiled from METHOD, HEADERS and CURL_OPTIONS arguments
+  // compiled parts are immutable and shared, so copying a template is cheap
+  struct request_template {
+    std::string method;
+    std::shared_ptr<const compiled_headers> headers;
+    std::shared_ptr<const std::vector<compiled_curl_option>> curl_options;
+    request_options options;
+  };
+
+  // define a growable binary safe buffer receiving response bodies, reused for all rows of a statement
+  struct response_buffer {
+    char *data = nullptr;
+    size_t size = 0;
+    size_t capacity = 0;
+
+    // set during a transfer to size the buffer from content length
+    CURL *curl = nullptr;
+    bool exceeded = false;
+
+    response_buffer() = default;
+    response_buffer(const response_buffer &) = delete;
+    response_buffer &operator=(const response_buffer &) = delete;
+
+    ~response_buffer() {
+      free(data);
+    }
+
+    // make room for given number of bytes, one extra byte is kept for a terminating null
+    bool reserve(size_t required) {
+      if (data != nullptr && required < capacity) {
+        return true;
+      }
+
+      size_t new_capacity = capacity > 0 ? capacity : 4096;
+      while (new_capacity <= required) {
+        new_capacity *= 2;
+      }
+
+      char *new_data = static_cast<char *>(realloc(data, new_capacity));
+      if (new_data == nullptr) {
+        return false;
+      }
+
+      data = new_data;
+      capacity = new_capacity;
+      return true;
+    }
+
+    bool append(const char *bytes, size_t length) {
+      if (!reserve(size + length)) {
+        return false;
+      }
+
+      memcpy(data + size, bytes, length);
+      size += length;
+      data[size] = '\0';
+      return true;
+    }
+
+    bool assign(const char *bytes, size_t length) {
+      clear();
+      return append(bytes, length);
+    }
+
+    // exchange received data with another buffer
+    void swap(response_buffer &other) {
+      std::swap(data, other.data);
+      std::swap(size, other.size);
+      std::swap(capacity, other.capacity);
+      std::swap(exceeded, other.exceeded);
+    }
+
+    void clear() {
+      size = 0;
+      curl = nullptr;
+      exceeded = false;
+      if (data != nullptr) {
+        data[0] = '\0';
+      }
+    }
+  };
+
+  // define a named request profile, it is immutable once published so requests read it without locks
+  struct request_profile {
+    std::string name;
+    std::string base_url;
+    request_template tmpl;
+
+    // connections to the service of a profile are not shared with other requests
+    std::shared_ptr<curl_handle_pool> pool;
+  };
+
+  // keep profiles in a map which is copied on write and published by an atomic pointer swap
+  // readers never take a lock, writers are serialized and rare
+  class profile_registry {
+    private:
+      typedef std::unordered_map<std::string, std::shared_ptr<const request_profile>> profile_map;
+
+      std::mutex write_lock;
+      std::shared_ptr<const profile_map> profiles = std::make_shared<profile_map>();
+
+    public:
+      std::shared_ptr<const request_profile> get(const std::string &name) const {
+        auto current = std::atomic_load(&profiles);
+        auto it = current->find(name);
+        return it != current->end() ? it->second : nullptr;
+      }
+
+      // publish a profile, connection pool of a replaced profile is kept to reuse its connections
+      void set(std::shared_ptr<request_profile> profile) {
+        std::lock_guard<std::mutex> guard(write_lock);
+        auto next = std::make_shared<profile_map>(*profiles);
+
+        auto it = next->find(profile->name);
+        profile->pool = it != next->end() ? it->second->pool : std::make_shared<curl_handle_pool>();
+        (*next)[profile->name] = std::move(profile);
+        std::atomic_store(&profiles, std::shared_ptr<const profile_map>(std::move(next)));
+      }
+
+      bool drop(const std::string &name) {
+        std::lock_guard<std::mutex> guard(write_lock);
+        if (profiles->count(name) == 0) {
+          return false;
+        }
+
+        auto next = std::make_shared<profile_map>(*profiles);
+        next->erase(name);
+        std::atomic_store(&profiles, std::shared_ptr<const profile_map>(std::move(next)));
+        return true;
+      }
+  };
+  profile_registry *my_profile_registry;
+
+  // define state of a udf call kept from init to deinit
+  struct udf_context {
+    // parts of the request which are constant for the whole statement
+    request_template constant;
+    bool constant_method = false;
+    bool constant_headers = false;
+    bool constant_curl_options = false;
+
+    // response of the last row
+    response_buffer result;
+  };
+
+  // uppercase given request method
+  void compile_method(const char *method, request_template &tmpl) {
+    tmpl.method = method != nullptr ? method : "GET";
+    std::transform(tmpl.method.begin(), tmpl.method.end(), tmpl.method.begin(), ::toupper);
+  }
+
+  // resolve json object of headers into a curl header list
+  void compile_headers(const json &headers_json, request_template &tmpl) {
+    tmpl.headers = nullptr;
+    auto compiled = std::make_shared<compiled_headers>();
+
+    for (auto& item : headers_json.items())
+    {
+      auto header = item.key() + ": " + item.value().get<std::string>();
+      compiled->list = curl_slist_append(compiled->list, header.c_str());
+    }
+
+    if (compiled->list != nullptr) {
+      tmpl.headers = std::move(compiled);
+    }
+  }
+
+  // parse json object of headers into a curl header list
+  void compile_headers(const char *headers, request_template &tmpl) {
+    tmpl.headers = nullptr;
+    if (headers == nullptr || strcmp(headers, "") == 0) {
+      return;
+    }
+
+    compile_headers(json::parse(headers), tmpl);
+  }
+
+  // read a json boolean or number as a flag
+  bool get_flag(const json &value) {
+    return value.is_boolean() ? value.get<bool>() : value.get<long>() != 0;
+  }
+
+  // resolve json object of curl options against supported options
+  void compile_curl_options(const json &curl_options_json, request_template &tmpl) {
+    tmpl.curl_options = nullptr;
+    tmpl.options = request_options();
+    auto compiled = std::make_shared<std::vector<compiled_curl_option>>();
+
+    for (auto& item : curl_options_json.items())
+    {
+      // component settings are not passed to curl
+      if (item.key() == "HTTPCLIENT_DECODE") {
+        tmpl.options.decode = get_flag(item.value()) ? 1 : 0;
+        continue;
+      }
+      if (item.key() == "HTTPCLIENT_COMPRESS") {
+        auto encoding = item.value().get<std::string>();
+        std::transform(encoding.begin(), encoding.end(), encoding.begin(), ::tolower);
+        if (encoding == "gzip") {
+          tmpl.options.compress = COMPRESSION_GZIP;
+        }
+        else if (encoding == "zstd") {
+          tmpl.options.compress = COMPRESSION_ZSTD;
+        }
+        else if (encoding == "none" || encoding.empty()) {
+          tmpl.options.compress = COMPRESSION_NONE;
+        }
+        else {
+          throw std::runtime_error("HTTPCLIENT_COMPRESS must be gzip, zstd or none");
+        }
+        continue;
+      }
+      if (item.key() == "HTTPCLIENT_COMPRESS_LEVEL") {
+        tmpl.options.compress_level = item.value().get<int>();
+        continue;
+      }
+      if (item.key() == "HTTPCLIENT_FSYNC") {
+        tmpl.options.fsync = get_flag(item.value());
+        continue;
+      }
+      if (item.key() == "HTTPCLIENT_RETRIES") {
+        tmpl.options.retries = std::max(0L, item.value().get<long>());
+        continue;
+      }
+      if (item.key() == "HTTPCLIENT_RETRY_BACKOFF_MS") {
+        tmpl.options.retry_backoff_ms = std::max(0L, item.value().get<long>());
+        continue;
+      }
+      if (item.key() == "HTTPCLIENT_DEADLINE_MS") {
+        tmpl.options.deadline_ms = std::max(0L, item.value().get<long>());
+        continue;
+      }
+      if (item.key() == "HTTPCLIENT_HEDGE_MS") {
+        tmpl.options.hedge_ms = item.value().is_string() && item.value().get<std::string>() == "p95" ? -1 : std::max(0L, item.value().get<long>());
+        continue;
+      }
+      if (item.key() == "HTTPCLIENT_CHUNKED") {
+        tmpl.options.chunked = get_flag(item.value());
+        continue;
+      }
+      if (item.key() == "HTTPCLIENT_COALESCE_MS") {
+        tmpl.options.coalesce_ms = std::max(0L, item.value().get<long>());
+        continue;
+      }
+
+      auto definition = find_curl_option(item.key());
+      if (definition == nullptr) {
+        continue;
+      }
+
+      compiled_curl_option opt;
+      opt.option = definition->option;
+      opt.type = definition->type;
+      opt.long_value = 0;
+      opt.off_value = 0;
+
+      if (opt.type == CURLOPTTYPE_LONG) {
+        opt.long_value = item.value().get<long>();
+      }
+      else if (opt.type == CURLOPTTYPE_OFF_T) {
+        opt.off_value = item.value().get<curl_off_t>();
+      }
+      else if (opt.type == CURLOPTTYPE_STRINGPOINT) {
+        opt.string_value = item.value().get<std::string>();
+      }
+      else {
+        continue;
+      }
+
+      compiled->push_back(std::move(opt));
+    }
+
+    tmpl.curl_options = std::move(compiled);
+  }
+
+  // parse json object of curl options and resolve them against supported options
+  void compile_curl_options(const char *curl_options, request_template &tmpl) {
+    tmpl.curl_options = nullptr;
+    tmpl.options = request_options();
+    if (curl_options == nullptr || strcmp(curl_options, "") == 0) {
+      return;
+    }
+
+    compile_curl_options(json::parse(curl_options), tmpl);
+  }
+
+  // resolve the request template of current row from constant and per row arguments
+  void compile_request(const udf_context *context, UDF_ARGS *args, request_template &tmpl) {
+    tmpl = context->constant;
+
+    if (!context->constant_method) {
+      compile_method(args->args[0], tmpl);
+    }
+    if (!context->constant_headers) {
+      compile_headers(args->arg_count > 3 ? args->args[3] : nullptr, tmpl);
+    }
+    if (!context->constant_curl_options) {
+      compile_curl_options(args->arg_count > 4 ? args->args[4] : nullptr, tmpl);
+    }
+  }
+
+  // define a request body in a buffer owned by the caller, e.g. a udf argument, which is sent without copying it
+  // read position is only used by chunked uploads and reset for each transfer
+  struct request_body {
+    const char *data = nullptr;
+    size_t length = 0;
+    size_t offset = 0;
+
+    request_body() = default;
+    request_body(const char *data, size_t length) : data(data), length(length) {}
+  };
+
+  // curl read function streaming a request body from its buffer
+  size_t body_read_callback(char *buffer, size_t size, size_t nitems, void *userp) {
+    request_body *body = static_cast<request_body *>(userp);
+    size_t count = std::min(size * nitems, body->length - body->offset);
+    memcpy(buffer, body->data + body->offset, count);
+    body->offset += count;
+    return count;
+  }
+
+  // curl seek function rewinding a request body, e.g. to send it again after a redirect
+  int body_seek_callback(void *userp, curl_off_t offset, int origin) {
+    request_body *body = static_cast<request_body *>(userp);
+    if (origin != SEEK_SET || offset < 0 || (size_t)offset > body->length) {
+      return CURL_SEEKFUNC_CANTSEEK;
+    }
+
+    body->offset = (size_t)offset;
+    return CURL_SEEKFUNC_OK;
+  }
+
+  // check if the statement of a session is killed by KILL QUERY, a closed connection or max_execution_time
+  bool statement_killed(MYSQL_THD thd) {
+    uint16_t status = STATUS_SESSION_OK;
+    if (thd == nullptr || mysql_service_mysql_thd_attributes->get(thd, "thd_status", &status)) {
+      return false;
+    }
+    return status != STATUS_SESSION_OK;
+  }
+
+  // curl progress function aborting transfers of killed statements, it is called at least once a second while waiting
+  int statement_progress_callback(void *userp, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+    if (statement_killed(static_cast<MYSQL_THD>(userp))) {
+      aborted_requests++;
+      return 1;
+    }
+    return 0;
+  }
+
+  // describe a failed transfer, transfers aborted by the progress function belong to killed statements
+  const char *transfer_error(CURLcode res) {
+    return res == CURLE_ABORTED_BY_CALLBACK ? "statement is killed" : curl_easy_strerror(res);
+  }
+
+  // configure given handle to send a request, url and body must outlive the transfer
+  // responses kept in memory are limited by max response size, responses streamed to a file are not
+  void setup_request(CURL *curl, const request_template &tmpl, const char *url, request_body &body, bool in_memory = true) {
+    // abort responses larger than allowed as soon as their content length is known
+    if (in_memory && max_response_size > 0) {
+      curl_easy_setopt(curl, CURLOPT_MAXFILESIZE_LARGE, (curl_off_t)max_response_size);
+    }
+
+    // let curl negotiate and decode any supported content encoding, given curl options can still override it
+    if (tmpl.options.decode > 0 || (tmpl.options.decode < 0 && accept_encoding)) {
+      curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
+    }
+
+    // requests sent from a session stop with its statement, background threads have no session
+    MYSQL_THD thd = nullptr;
+    if (!mysql_service_mysql_current_thread_reader->get(&thd) && thd != nullptr) {
+      curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+      curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, statement_progress_callback);
+      curl_easy_setopt(curl, CURLOPT_XFERINFODATA, thd);
+    }
+
+    // curl sends "Expect: 100-continue" for large and chunked bodies and waits a second for the interim response
+    // send the body right away instead, servers rejecting it still respond early, given curl options can still override it
+    if (body.data != nullptr) {
+      curl_easy_setopt(curl, CURLOPT_EXPECT_100_TIMEOUT_MS, 0L);
+    }
+
+    // set all given curl options and headers
+    if (tmpl.curl_options != nullptr) {
+      for (auto& opt : *tmpl.curl_options) {
+        // curl reads variadic option values by type, so off_t options must be passed as curl_off_t
+        if (opt.type == CURLOPTTYPE_LONG) {
+          curl_easy_setopt(curl, opt.option, opt.long_value);
+        }
+        else if (opt.type == CURLOPTTYPE_OFF_T) {
+          curl_easy_setopt(curl, opt.option, opt.off_value);
+        }
+        else {
+          curl_easy_setopt(curl, opt.option, opt.string_value.c_str());
+        }
+      }
+    }
+
+    if (tmpl.headers != nullptr) {
+      curl_easy_setopt(curl, CURLOPT_HTTPHEADER, tmpl.headers->list);
+    }
+
+    // set request method and url
+    curl_easy_setopt(curl, CURLOPT_URL, url);
+
+    if (tmpl.method == "POST") {
+      curl_easy_setopt(curl, CURLOPT_POST, 1);
+    }
+    else if (tmpl.method == "PUT" || tmpl.method == "PATCH" || tmpl.method == "DELETE") {
+      curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, tmpl.method.c_str());
+    }
+    else {
+      curl_easy_setopt(curl, CURLOPT_HTTPGET, 1);
+      curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "GET");
+    }
+
+    if (body.data == nullptr) {
+      return;
+    }
+
+    // an unknown length makes curl send the body in chunks as the read function returns it
+    if (tmpl.options.chunked) {
+      body.offset = 0;
+      curl_easy_setopt(curl, CURLOPT_POST, 1L);
+      curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t)-1);
+      curl_easy_setopt(curl, CURLOPT_READFUNCTION, body_read_callback);
+      curl_easy_setopt(curl, CURLOPT_READDATA, &body);
+      curl_easy_setopt(curl, CURLOPT_SEEKFUNCTION, body_seek_callback);
+      curl_easy_setopt(curl, CURLOPT_SEEKDATA, &body);
+      return;
+    }
+
+    // body length is given so curl neither scans the buffer nor stops at a NUL byte of binary bodies
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t)body.length);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.data);
+  }
+
+  // copy header list of a template so headers can be added for a single request
+  std::shared_ptr<compiled_headers> copy_headers(const request_template &tmpl) {
+    auto compiled = std::make_shared<compiled_headers>();
+    if (tmpl.headers != nullptr) {
+      for (auto item = tmpl.headers->list; item != nullptr; item = item->next) {
+        compiled->list = curl_slist_append(compiled->list, item->data);
+      }
+    }
+    return compiled;
+  }
+
+  // compress a body into a gzip stream, returns false on failure
+  bool gzip_compress(const char *body, size_t body_length, int level, std::string &encoded) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+
+    // window bits above 15 write a gzip header instead of zlib
+    if (deflateInit2(&stream, level > 0 ? std::min(level, 9) : Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+      return false;
+    }
+
+    encoded.resize(deflateBound(&stream, (uLong)body_length));
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(body));
+    stream.avail_in = (uInt)body_length;
+    stream.next_out = reinterpret_cast<Bytef *>(&encoded[0]);
+    stream.avail_out = (uInt)encoded.size();
+
+    int result = deflate(&stream, Z_FINISH);
+    encoded.resize(stream.total_out);
+    deflateEnd(&stream);
+    return result == Z_STREAM_END;
+  }
+
+  // compress a body into a zstd frame, returns false on failure
+  bool zstd_compress(const char *body, size_t body_length, int level, std::string &encoded) {
+    encoded.resize(ZSTD_compressBound(body_length));
+    size_t size = ZSTD_compress(&encoded[0], encoded.size(), body, body_length, level > 0 ? level : ZSTD_CLEVEL_DEFAULT);
+    if (ZSTD_isError(size)) {
+      return false;
+    }
+
+    encoded.resize(size);
+    return true;
+  }
+
+  // compress a request body with the encoding given by HTTPCLIENT_COMPRESS if it is at least httpclient.compress_min_size bytes
+  // returns true if the compressed body is written into encoded, a content-encoding header is then added to the template
+  bool encode_body(request_template &tmpl, const char *body, size_t body_length, std::string &encoded) {
+    if (tmpl.options.compress == COMPRESSION_NONE || body == nullptr || body_length < compress_min_size || body_length > UINT_MAX) {
+      return false;
+    }
+
+    // a body with a content encoding given in headers is already encoded
+    if (tmpl.headers != nullptr) {
+      for (auto item = tmpl.headers->list; item != nullptr; item = item->next) {
+        if (strncasecmp(item->data, "content-encoding:", 17) == 0) {
+          return false;
+        }
+      }
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+    bool gzip = tmpl.options.compress == COMPRESSION_GZIP;
+    bool compressed = gzip ? gzip_compress(body, body_length, tmpl.options.compress_level, encoded) : zstd_compress(body, body_length, tmpl.options.compress_level, encoded);
+    compression_time_us += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count();
+
+    // send incompressible bodies as they are
+    if (!compressed || encoded.size() >= body_length) {
+      encoded.clear();
+      return false;
+    }
+
+    compressed_requests++;
+    compression_bytes_in += body_length;
+    compression_bytes_out += encoded.size();
+
+    auto compiled = copy_headers(tmpl);
+    compiled->list = curl_slist_append(compiled->list, gzip ? "Content-Encoding: gzip" : "Content-Encoding: zstd");
+    tmpl.headers = std::move(compiled);
+    return true;
+  }
+
+  // curl write function
+  size_t write_callback(void *contents, size_t size, size_t nmemb, void *userp) {
+    size_t total_size = size * nmemb;
+    std::string *response = static_cast<std::string *>(userp);
+    response->append(static_cast<const char *>(contents), total_size);
+    return total_size;
+  }
+
+  // return host part of an url
+  std::string_view url_host(std::string_view url) {
+    auto scheme = url.find("://");
+    if (scheme != std::string_view::npos) {
+      url.remove_prefix(scheme + 3);
+    }
+
+    url = url.substr(0, url.find_first_of("/?#"));
+    auto credentials = url.rfind('@');
+    if (credentials != std::string_view::npos) {
+      url.remove_prefix(credentials + 1);
+    }
+    return url;
+  }
+
+  // start a history record of a request sent by current thread
+  void init_record(request_record &record, const std::string &method, const char *url) {
+    memset(&record, 0, sizeof(record));
+    record.timestamp_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+    // background threads have no session
+    MYSQL_THD thd = nullptr;
+    if (!mysql_service_mysql_current_thread_reader->get(&thd) && thd != nullptr) {
+      uint32_t thread_id = 0;
+      if (!mysql_service_mysql_thd_attributes->get(thd, "thread_id", &thread_id)) {
+        record.thread_id = thread_id;
+      }
+    }
+
+    record.method_length = std::min(method.size(), sizeof(record.method));
+    memcpy(record.method, method.data(), record.method_length);
+
+    auto host = url_host(url);
+    record.host_length = std::min(host.size(), sizeof(record.host));
+    memcpy(record.host, host.data(), record.host_length);
+  }
+
+  // add a request served from response cache to history
+  void record_cache_hit(const std::string &method, const char *url) {
+    if (my_request_history->capacity() == 0) {
+      return;
+    }
+
+    request_record record;
+    init_record(record, method, url);
+    record.status = 200;
+    record.cache_hit = true;
+    my_request_history->add(record);
+  }
+
+  // queue an error which does not belong to a transfer to error log
+  void log_error(const char *message) {
+    if (log_level < LOG_LEVEL_ERROR) {
+      return;
+    }
+
+    auto record = new log_record();
+    record->level = ERROR_LEVEL;
+    record->message = message;
+    my_request_logger->log(record);
+  }
+
+  // queue result of a finished request to error log if it passes log level, slow threshold and sampling
+  void log_request(const std::string &method, const char *url, long http_status_code, CURLcode res, unsigned long long elapsed_ms) {
+    loglevel level;
+    if (res != CURLE_OK) {
+      if (log_level < LOG_LEVEL_ERROR) {
+        return;
+      }
+      level = ERROR_LEVEL;
+    }
+    else if ((log_slow_ms > 0 && elapsed_ms >= log_slow_ms) || http_status_code >= 500) {
+      if (log_level < LOG_LEVEL_WARNING) {
+        return;
+      }
+      level = WARNING_LEVEL;
+    }
+    else {
+      if (log_level < LOG_LEVEL_INFORMATION) {
+        return;
+      }
+
+      // log 1 in N requests, counted per thread to avoid a shared counter
+      thread_local unsigned long long seen = 0;
+      if (log_sample_rate > 1 && ++seen % log_sample_rate != 0) {
+        return;
+      }
+      level = INFORMATION_LEVEL;
+    }
+
+    auto record = new log_record();
+    record->level = level;
+    record->method = method;
+    record->url = url;
+    record->status = http_status_code;
+    record->res = res;
+    record->elapsed_ms = elapsed_ms;
+    my_request_logger->log(record);
+  }
+
+  // update request statistics from timings and sizes of a finished transfer and log it
+  void record_transfer(CURL *curl, CURLcode res, long http_status_code, const std::string &method, const char *url) {
+    // curl timings are microseconds since start of the transfer, zero for phases that were skipped
+    curl_off_t namelookup = 0, connect = 0, appconnect = 0, starttransfer = 0, total = 0, uploaded = 0, downloaded = 0;
+    curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME_T, &namelookup);
+    curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &connect);
+    curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME_T, &appconnect);
+    curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &starttransfer);
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &total);
+    curl_easy_getinfo(curl, CURLINFO_SIZE_UPLOAD_T, &uploaded);
+    curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &downloaded);
+
+    number_of_requests.add(1);
+    time_spent_us.add((unsigned long long)total);
+    bytes_sent.add((unsigned long long)uploaded);
+    bytes_received.add((unsigned long long)downloaded);
+
+    // reused connections skip name lookup, connect and tls handshake
+    if (connect > namelookup) {
+      dns_latency.record((unsigned long long)namelookup);
+      connect_latency.record((unsigned long long)(connect - namelookup));
+    }
+    if (appconnect > connect) {
+      tls_latency.record((unsigned long long)(appconnect - connect));
+    }
+    if (starttransfer > 0) {
+      ttfb_latency.record((unsigned long long)starttransfer);
+    }
+    total_latency.record((unsigned long long)total);
+
+    if (res != CURLE_OK) {
+      failed_requests.add(1);
+      if (res > 0 && res < CURL_LAST) {
+        errors_by_code[res].fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    else if (http_status_code >= 100 && http_status_code < 600) {
+      responses_by_class[http_status_code / 100 - 1]->add(1);
+    }
+
+    log_request(method, url, http_status_code, res, (unsigned long long)total / 1000);
+
+    if (my_request_history->capacity() == 0) {
+      return;
+    }
+
+    long new_connections = 0;
+    curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &new_connections);
+
+    request_record record;
+    init_record(record, method, url);
+    record.status = http_status_code;
+    record.curl_code = res;
+    record.bytes_sent = (unsigned long long)uploaded;
+    record.bytes_received = (unsigned long long)downloaded;
+    record.dns_us = connect > namelookup ? (unsigned long long)namelookup : 0;
+    record.connect_us = connect > namelookup ? (unsigned long long)(connect - namelookup) : 0;
+    record.tls_us = appconnect > connect ? (unsigned long long)(appconnect - connect) : 0;
+    record.ttfb_us = (unsigned long long)starttransfer;
+    record.total_us = (unsigned long long)total;
+    record.connection_reused = new_connections == 0;
+    my_request_history->add(record);
+  }
+
+  // hold a concurrency slot and rate limit token of a host for a single request
+  class host_permit {
+    private:
+      std::shared_ptr<host_state> state;
+      bool probe = false;
+      bool finished = false;
+
+      void release() {
+        state->in_flight--;
+        if (probe) {
+          state->probe_in_flight = false;
+        }
+        state->slot_available.notify_one();
+      }
+
+    public:
+      ~host_permit() {
+        if (state != nullptr && !finished) {
+          std::lock_guard<std::mutex> guard(state->lock);
+          release();
+        }
+      }
+
+      // wait for a slot and a token of the host of given url, fails fast while its circuit breaker is open
+      bool acquire(const char *url, std::string &message) {
+        if (!my_host_registry->enabled()) {
+          return true;
+        }
+
+        std::string host(url_host(url));
+        std::transform(host.begin(), host.end(), host.begin(), ::tolower);
+        auto host_state_ptr = my_host_registry->get(host);
+        host_state &s = *host_state_ptr;
+
+        auto now = std::chrono::steady_clock::now();
+        auto deadline = now + std::chrono::milliseconds(host_wait_timeout_ms);
+        std::unique_lock<std::mutex> guard(s.lock);
+
+        if (breaker_failure_threshold > 0 && s.breaker != host_state::CLOSED) {
+          // after open period a single request probes the host
+          if (s.breaker == host_state::OPEN && now - s.opened_at >= std::chrono::milliseconds(breaker_open_ms)) {
+            s.breaker = host_state::HALF_OPEN;
+          }
+
+          if (s.breaker == host_state::OPEN || s.probe_in_flight) {
+            breaker_rejected++;
+            message = "circuit breaker of " + host + " is open";
+            return false;
+          }
+
+          s.probe_in_flight = true;
+          probe = true;
+        }
+
+        long max_in_flight = s.max_in_flight >= 0 ? s.max_in_flight : host_max_in_flight;
+        while (max_in_flight > 0 && s.in_flight >= (unsigned long)max_in_flight) {
+          if (s.slot_available.wait_until(guard, deadline) == std::cv_status::timeout) {
+            if (probe) {
+              s.probe_in_flight = false;
+            }
+            host_limit_timeouts++;
+            message = "too many concurrent requests to " + host;
+            return false;
+          }
+          max_in_flight = s.max_in_flight >= 0 ? s.max_in_flight : host_max_in_flight;
+        }
+
+        // reserve a token, requests wait in line for their token outside of the lock
+        std::chrono::steady_clock::duration wait(0);
+        long rate_limit = s.rate_limit >= 0 ? s.rate_limit : host_rate_limit;
+        if (rate_limit > 0) {
+          now = std::chrono::steady_clock::now();
+          double elapsed = std::chrono::duration<double>(now - s.refilled_at).count();
+          s.tokens = std::min((double)rate_limit, s.tokens + elapsed * rate_limit);
+          s.refilled_at = now;
+
+          if (s.tokens < 1) {
+            wait = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>((1 - s.tokens) / rate_limit));
+            if (now + wait > deadline) {
+              if (probe) {
+                s.probe_in_flight = false;
+              }
+              host_limit_timeouts++;
+              message = "request rate limit of " + host + " exceeded";
+              return false;
+            }
+          }
+          s.tokens -= 1;
+        }
+
+        s.in_flight++;
+        state = std::move(host_state_ptr);
+        guard.unlock();
+
+        if (wait.count() > 0) {
+          std::this_thread::sleep_for(wait);
+        }
+        return true;
+      }
+
+      // release the slot and update circuit breaker with result of the transfer
+      void finish(CURL *curl, CURLcode res, long http_status_code) {
+        if (state == nullptr || finished) {
+          return;
+        }
+
+        curl_off_t total = 0;
+        curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &total);
+        bool failed = res != CURLE_OK || http_status_code >= 500 || (breaker_latency_ms > 0 && (unsigned long long)total >= breaker_latency_ms * 1000ULL);
+
+        std::lock_guard<std::mutex> guard(state->lock);
+        finished = true;
+        release();
+
+        if (breaker_failure_threshold == 0) {
+          return;
+        }
+
+        if (probe) {
+          if (failed) {
+            state->breaker = host_state::OPEN;
+            state->opened_at = std::chrono::steady_clock::now();
+          }
+          else {
+            state->breaker = host_state::CLOSED;
+            state->failures = 0;
+            breakers_open--;
+          }
+        }
+        else if (failed) {
+          state->failures++;
+          if (state->breaker == host_state::CLOSED && state->failures >= breaker_failure_threshold) {
+            state->breaker = host_state::OPEN;
+            state->opened_at = std::chrono::steady_clock::now();
+            breakers_open++;
+          }
+        }
+        else {
+          state->failures = 0;
+        }
+      }
+  };
+
+  // curl write function appending to a response buffer, aborts the transfer above max response size
+  size_t buffer_write_callback(void *contents, size_t size, size_t nmemb, void *userp) {
+    size_t total_size = size * nmemb;
+    response_buffer *buffer = static_cast<response_buffer *>(userp);
+
+    if (max_response_size > 0 && buffer->size + total_size > max_response_size) {
+      buffer->exceeded = true;
+      return 0;
+    }
+
+    // size the buffer once from content length instead of growing it step by step
+    if (buffer->size == 0 && buffer->curl != nullptr) {
+      curl_off_t content_length = -1;
+      curl_easy_getinfo(buffer->curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &content_length);
+      if (content_length > 0 && (max_response_size == 0 || (curl_off_t)max_response_size >= content_length)) {
+        buffer->reserve((size_t)content_length);
+      }
+    }
+
+    if (!buffer->append(static_cast<const char *>(contents), total_size)) {
+      return 0;
+    }
+    return total_size;
+  }
+
+  // curl write function which discards the response
+  size_t discard_callback(void *, size_t size, size_t nmemb, void *) {
+    return size * nmemb;
+  }
+
+  // define a request owned by the background dispatcher until its transfer is finished
+  struct background_request {
+    request_template tmpl;
+    std::string url;
+    std::string body;
+    bool has_body = false;
+    request_body upload;
+
+    // id of the stored response, responses of http_request_nowait are discarded
+    unsigned long long async_id = 0;
+    std::string response;
+  };
+
+  // run queued requests concurrently on a single curl multi handle in a component owned thread
+  class background_dispatcher {
+    private:
+      bounded_queue<background_request *> queue;
+      CURLM *multi = nullptr;
+      std::thread thread;
+      std::atomic<bool> running{false};
+
+      // used by producers waiting for free space with BLOCK overflow policy
+      std::mutex space_lock;
+      std::condition_variable space_available;
+
+      // only accessed by dispatcher thread
+      std::vector<CURL *> in_flight;
+
+      void start_transfer(background_request *request) {
+        CURL *curl = my_curl_handle_pool->acquire();
+        if (curl == nullptr) {
+          nowait_failed++;
+          delete request;
+          return;
+        }
+
+        // user given options may override the default timeout
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, (long)nowait_timeout_ms);
+        request->upload = request_body(request->has_body ? request->body.data() : nullptr, request->body.size());
+        setup_request(curl, request->tmpl, request->url.c_str(), request->upload);
+        if (request->async_id != 0) {
+          curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
+          curl_easy_setopt(curl, CURLOPT_WRITEDATA, &request->response);
+        }
+        else {
+          curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, discard_callback);
+        }
+        curl_easy_setopt(curl, CURLOPT_PRIVATE, request);
+
+        if (curl_multi_add_handle(multi, curl) != CURLM_OK) {
+          nowait_failed++;
+          my_curl_handle_pool->release(curl);
+          delete request;
+          return;
+        }
+
+        in_flight.push_back(curl);
+      }
+
+      void finish_transfer(CURL *curl, CURLcode res) {
+        background_request *request = nullptr;
+        long http_status_code = -1;
+        curl_easy_getinfo(curl, CURLINFO_PRIVATE, reinterpret_cast<char **>(&request));
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_status_code);
+        record_transfer(curl, res, http_status_code, request->tmpl.method, request->url.c_str());
+
+        curl_multi_remove_handle(multi, curl);
+        in_flight.erase(std::find(in_flight.begin(), in_flight.end(), curl));
+        my_curl_handle_pool->release(curl);
+
+        if (request->async_id != 0) {
+          // failed transfers are stored with status 0 so they are not pending forever
+          my_async_response_store->complete(request->async_id, res == CURLE_OK ? http_status_code : 0, std::move(request->response));
+        }
+
+        if (res == CURLE_OK) {
+          nowait_completed++;
+        }
+        else {
+          nowait_failed++;
+        }
+
+        delete request;
+      }
+
+      void run() {
+        std::chrono::steady_clock::time_point drain_deadline;
+        auto next_expiry = std::chrono::steady_clock::now();
+        bool draining = false;
+
+        while (true) {
+          // drop async responses nobody collected in time
+          if (std::chrono::steady_clock::now() >= next_expiry) {
+            my_async_response_store->expire();
+            next_expiry = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+          }
+
+          if (!draining && !running.load()) {
+            // finish queued and running requests within one request timeout after stop
+            draining = true;
+            drain_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(nowait_timeout_ms);
+          }
+
+          if (draining && std::chrono::steady_clock::now() >= drain_deadline) {
+            break;
+          }
+
+          // start queued requests up to the concurrency limit
+          bool dequeued = false;
+          background_request *request;
+          while (in_flight.size() < nowait_max_in_flight && queue.pop(request)) {
+            start_transfer(request);
+            dequeued = true;
+          }
+
+          if (dequeued) {
+            std::lock_guard<std::mutex> guard(space_lock);
+            space_available.notify_all();
+          }
+
+          int still_running = 0;
+          curl_multi_perform(multi, &still_running);
+
+          CURLMsg *msg;
+          int msgs_left = 0;
+          while ((msg = curl_multi_info_read(multi, &msgs_left)) != nullptr) {
+            if (msg->msg == CURLMSG_DONE) {
+              finish_transfer(msg->easy_handle, msg->data.result);
+            }
+          }
+
+          if (draining && in_flight.empty() && queue.empty()) {
+            break;
+          }
+
+          // sleep until a socket is ready, a request is submitted or stop is requested
+          curl_multi_poll(multi, nullptr, 0, 1000, nullptr);
+        }
+
+        // abort whatever could not be finished in time
+        while (!in_flight.empty()) {
+          CURL *curl = in_flight.back();
+          background_request *request = nullptr;
+          curl_easy_getinfo(curl, CURLINFO_PRIVATE, reinterpret_cast<char **>(&request));
+          curl_multi_remove_handle(multi, curl);
+          in_flight.pop_back();
+          my_curl_handle_pool->release(curl);
+          if (request->async_id != 0) {
+            my_async_response_store->complete(request->async_id, 0, std::string());
+          }
+          delete request;
+          nowait_failed++;
+        }
+
+        background_request *request;
+        while (queue.pop(request)) {
+          delete request;
+          nowait_dropped++;
+        }
+      }
+
+    public:
+      explicit background_dispatcher(size_t capacity) : queue(capacity) {}
+
+      ~background_dispatcher() {
+        stop();
+      }
+
+      // create multi handle and start dispatcher thread
+      bool start() {
+        multi = curl_multi_init();
+        if (multi == nullptr) {
+          return false;
+        }
+
+        running = true;
+        thread = std::thread(&background_dispatcher::run, this);
+        return true;
+      }
+
+      // drain queued requests and wait for dispatcher thread to exit
+      void stop() {
+        if (!thread.joinable()) {
+          return;
+        }
+
+        running = false;
+        curl_multi_wakeup(multi);
+        {
+          std::lock_guard<std::mutex> guard(space_lock);
+          space_available.notify_all();
+        }
+        thread.join();
+
+        curl_multi_cleanup(multi);
+        multi = nullptr;
+      }
+
+      // queue given request, waits for free space only if block is set
+      bool submit(background_request *request, bool block) {
+        while (running.load()) {
+          if (queue.push(request)) {
+            curl_multi_wakeup(multi);
+            return true;
+          }
+
+          if (!block) {
+            break;
+          }
+
+          // the dispatcher notifies after dequeuing, timeout guards against a missed wakeup
+          std::unique_lock<std::mutex> guard(space_lock);
+          space_available.wait_for(guard, std::chrono::milliseconds(10));
+        }
+
+        return false;
+      }
+
+      size_t queue_depth() const {
+        return queue.size();
+      }
+  };
+  background_dispatcher *my_background_dispatcher;
+
+  // define a transfer of a session waiting for the transport thread to complete it
+  struct transport_request {
+    CURL *curl;
+    CURLcode res = CURLE_FAILED_INIT;
+    bool done = false;
+    std::mutex lock;
+    std::condition_variable done_signal;
+
+    explicit transport_request(CURL *curl) : curl(curl) {}
+  };
+
+  // run transfers of all sessions on a single curl multi handle in a component owned thread
+  // concurrent requests to an origin share its http/2 connections, origins without http/2 get pooled http/1.1 connections
+  class transport_dispatcher {
+    private:
+      CURLM *multi = nullptr;
+      std::thread thread;
+      std::atomic<bool> running{false};
+
+      // transfers submitted by sessions, moved to the multi handle by transport thread
+      std::mutex pending_lock;
+      std::vector<transport_request *> pending;
+
+      // only accessed by transport thread
+      std::vector<transport_request *> in_flight;
+      uint applied_streams = 0;
+
+      void complete(transport_request *request, CURLcode res) {
+        std::lock_guard<std::mutex> guard(request->lock);
+        request->res = res;
+        request->done = true;
+        request->done_signal.notify_one();
+      }
+
+      void start_transfers() {
+        std::vector<transport_request *> submitted;
+        {
+          std::lock_guard<std::mutex> guard(pending_lock);
+          submitted.swap(pending);
+        }
+
+        for (auto request : submitted) {
+          // wait for a connection being set up instead of opening another one, so streams can be multiplexed on it
+          curl_easy_setopt(request->curl, CURLOPT_PIPEWAIT, 1L);
+          curl_easy_setopt(request->curl, CURLOPT_PRIVATE, request);
+
+          if (curl_multi_add_handle(multi, request->curl) != CURLM_OK) {
+            complete(request, CURLE_FAILED_INIT);
+            continue;
+          }
+          in_flight.push_back(request);
+        }
+      }
+
+      void run() {
+        while (running.load()) {
+          // streams per connection can be changed at runtime
+          if (applied_streams != max_concurrent_streams) {
+            applied_streams = max_concurrent_streams;
+            curl_multi_setopt(multi, CURLMOPT_MAX_CONCURRENT_STREAMS, (long)applied_streams);
+          }
+
+          start_transfers();
+
+          int still_running = 0;
+          curl_multi_perform(multi, &still_running);
+
+          CURLMsg *msg;
+          int msgs_left = 0;
+          while ((msg = curl_multi_info_read(multi, &msgs_left)) != nullptr) {
+            if (msg->msg != CURLMSG_DONE) {
+              continue;
+            }
+
+            transport_request *request = nullptr;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, reinterpret_cast<char **>(&request));
+            CURLcode res = msg->data.result;
+            curl_multi_remove_handle(multi, msg->easy_handle);
+            in_flight.erase(std::find(in_flight.begin(), in_flight.end(), request));
+            complete(request, res);
+          }
+
+          // sleep until a socket is ready, a transfer is submitted or stop is requested
+          curl_multi_poll(multi, nullptr, 0, 1000, nullptr);
+        }
+
+        // sessions are gone once functions are unregistered, anything left is aborted
+        start_transfers();
+        for (auto request : in_flight) {
+          curl_multi_remove_handle(multi, request->curl);
+          complete(request, CURLE_ABORTED_BY_CALLBACK);
+        }
+        in_flight.clear();
+      }
+
+    public:
+      ~transport_dispatcher() {
+        stop();
+      }
+
+      // create multi handle with multiplexing and start transport thread
+      bool start() {
+        multi = curl_multi_init();
+        if (multi == nullptr) {
+          return false;
+        }
+
+        curl_multi_setopt(multi, CURLMOPT_PIPELINING, (long)CURLPIPE_MULTIPLEX);
+        curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, (long)std::max(connection_pool_size, 5U));
+
+        running = true;
+        thread = std::thread(&transport_dispatcher::run, this);
+        return true;
+      }
+
+      // abort transfers in flight and wait for transport thread to exit
+      void stop() {
+        if (!thread.joinable()) {
+          return;
+        }
+
+        running = false;
+        curl_multi_wakeup(multi);
+        thread.join();
+
+        curl_multi_cleanup(multi);
+        multi = nullptr;
+      }
+
+      // run a prepared transfer on the shared multi handle and wait for it, callbacks of the handle run in transport thread
+      CURLcode perform(CURL *curl) {
+        // connections of the multi handle are only used by transport thread, shared connections of other threads are not multiplexed
+        curl_easy_setopt(curl, CURLOPT_SHARE, nullptr);
+
+        transport_request request(curl);
+        {
+          std::lock_guard<std::mutex> guard(pending_lock);
+          pending.push_back(&request);
+        }
+        curl_multi_wakeup(multi);
+        multiplexed_requests++;
+
+        std::unique_lock<std::mutex> guard(request.lock);
+        request.done_signal.wait(guard, [&request]() { return request.done; });
+        return request.res;
+      }
+
+      bool is_running() const {
+        return running.load();
+      }
+  };
+  transport_dispatcher *my_transport_dispatcher;
+
+  // send a prepared request, on the shared transport if httpclient.multiplex is enabled
+  CURLcode perform_transfer(CURL *curl) {
+    if (multiplex && my_transport_dispatcher != nullptr && my_transport_dispatcher->is_running()) {
+      return my_transport_dispatcher->perform(curl);
+    }
+    return curl_easy_perform(curl);
+  }
+
+  // compile arguments that are constant for the whole statement, so rows only set url and body
+  static bool compile_constant_arguments(udf_context *context, UDF_ARGS *args, char *message) {
+    try {
+      if (args->arg_count > 0 && args->args[0] != nullptr) {
+        compile_method(args->args[0], context->constant);
+        context->constant_method = true;
+      }
+
+      if (args->arg_count > 3 && args->args[3] != nullptr) {
+        compile_headers(args->args[3], context->constant);
+        context->constant_headers = true;
+      }
+
+      if (args->arg_count > 4 && args->args[4] != nullptr) {
+        compile_curl_options(args->args[4], context->constant);
+        context->constant_curl_options = true;
+      }
+    }
+    catch (const std::exception& ex) {
+      snprintf(message, MYSQL_ERRMSG_SIZE, "invalid argument: %s", ex.what());
+      return true;
+    }
+
+    return false;
+  }
+
+  // create context of a request function and compile its constant arguments
+  static bool create_request_context(UDF_INIT *initid, UDF_ARGS *args, char *message) {
+    udf_context *context = new udf_context();
+    if (compile_constant_arguments(context, args, message)) {
+      delete context;
+      return true;
+    }
+
+    initid->ptr = reinterpret_cast<char *>(context);
+    return 0;
+  }
+
+  // initialize any given function
+  static bool httpclient_udf_init(UDF_INIT *initid, UDF_ARGS *args, char *message) {
+    const char* name = "utf8mb4";
+    char *value = const_cast<char*>(name);
+    if (mysql_service_mysql_udf_metadata->result_set(initid, "charset", const_cast<char *>(value))) {
+      LogComponentErr(ERROR_LEVEL, ER_LOG_PRINTF_MSG, "failed to set result charset");
+      return false;
+    }
+
+    if (create_request_context(initid, args, message)) {
+      return true;
+    }
+
+    // allocate response buffer once, it is reused and grown for all rows of the statement
+    reinterpret_cast<udf_context *>(initid->ptr)->result.reserve(16 * 1024);
+    return false;
+  }
+
+  // initialize functions returning an integer
+  static bool httpclient_int_udf_init(UDF_INIT *initid, UDF_ARGS *args, char *message) {
+    return create_request_context(initid, args, message);
+  }
+
+  // initialize functions reading a stored async response
+  static bool httpclient_response_udf_init(UDF_INIT *initid, UDF_ARGS *args, char *message) {
+    if (args->arg_count != 1) {
+      snprintf(message, MYSQL_ERRMSG_SIZE, "expected a single request id argument");
+      return true;
+    }
+    args->arg_type[0] = INT_RESULT;
+
+    const char* name = "utf8mb4";
+    char *value = const_cast<char*>(name);
+    if (mysql_service_mysql_udf_metadata->result_set(initid, "charset", const_cast<char *>(value))) {
+      LogComponentErr(ERROR_LEVEL, ER_LOG_PRINTF_MSG, "failed to set result charset");
+    }
+
+    initid->ptr = reinterpret_cast<char *>(new udf_context());
+    initid->maybe_null = true;
+    return 0;
+  }
+
+  // initialize functions reading status of a stored async response
+  static bool httpclient_response_status_udf_init(UDF_INIT *initid, UDF_ARGS *args, char *message) {
+    if (args->arg_count != 1) {
+      snprintf(message, MYSQL_ERRMSG_SIZE, "expected a single request id argument");
+      return true;
+    }
+    args->arg_type[0] = INT_RESULT;
+
+    initid->ptr = reinterpret_cast<char *>(new udf_context());
+    initid->maybe_null = true;
+    return 0;
+  }
+
+  // initialize functions executing a json array of requests
+  static bool httpclient_multi_udf_init(UDF_INIT *initid, UDF_ARGS *args, char *message) {
+    if (args->arg_count != 1) {
+      snprintf(message, MYSQL_ERRMSG_SIZE, "expected a single json array of requests");
+      return true;
+    }
+
+    const char* name = "utf8mb4";
+    char *value = const_cast<char*>(name);
+    if (mysql_service_mysql_udf_metadata->result_set(initid, "charset", const_cast<char *>(value))) {
+      LogComponentErr(ERROR_LEVEL, ER_LOG_PRINTF_MSG, "failed to set result charset");
+    }
+
+    initid->ptr = reinterpret_cast<char *>(new udf_context());
+    return 0;
+  }
+
+  // de-initialize any given function
+  static void httpclient_udf_deinit(UDF_INIT *initid) {
+    delete reinterpret_cast<udf_context *>(initid->ptr);
+    initid->ptr = nullptr;
+  }
+
+  // check if privilege is granted for current user
+  bool has_privilege(void *opaque_thd) {
+    // get the security context of the thread
+    Security_context_handle ctx = nullptr;
+    if (mysql_service_mysql_thd_security_context->get(opaque_thd, &ctx) || !ctx) {
+      LogComponentErr(ERROR_LEVEL, ER_LOG_PRINTF_MSG, "problem trying to get security context");
+      return false;
+    }
+
+    if (mysql_service_global_grants_check->has_global_grant(ctx, HTTPCLIENT_PRIVILEGE_NAME, strlen(HTTPCLIENT_PRIVILEGE_NAME))) {
+      return true;
+    }
+
+    return false;
+  }
+
+  // check privilege and arguments common to all request functions
+  bool validate_request(UDF_ARGS *args, char *is_null, char *error) {
+    MYSQL_THD thd;
+    mysql_service_mysql_current_thread_reader->get(&thd);
+
+    if (!has_privilege(thd)) {
+      mysql_error_service_printf(ER_SPECIFIC_ACCESS_DENIED_ERROR, 0, HTTPCLIENT_PRIVILEGE_NAME);
+      *error = 1;
+      *is_null = 1;
+      return false;
+    }
+
+    if (args->arg_count < 2) {
+      mysql_error_service_printf(ER_AUDIT_LOG_UDF_INVALID_ARGUMENT_COUNT, 0);
+      *error = 1;
+      *is_null = 1;
+      return false;
+    }
+
+    if (args->args[1] == nullptr) {
+      mysql_error_service_printf(ER_UDF_ERROR, 0, "http_request", "url must not be null");
+      *error = 1;
+      *is_null = 1;
+      return false;
+    }
+
+    return true;
+  }
+
+  // define cache related headers of a response
+  struct response_headers {
+    bool no_store = false;
+    bool no_cache = false;
+    long max_age = -1;
+    std::string etag;
+    std::string last_modified;
+    long retry_after = -1;
+  };
+
+  // curl header function collecting cache related headers of the final response
+  size_t header_callback(char *buffer, size_t size, size_t nitems, void *userp) {
+    size_t total_size = size * nitems;
+    response_headers *headers = static_cast<response_headers *>(userp);
+    std::string line(buffer, total_size);
+
+    // a new status line starts headers of a redirected or continued response
+    if (line.compare(0, 5, "HTTP/") == 0) {
+      *headers = response_headers();
+      return total_size;
+    }
+
+    auto colon = line.find(':');
+    if (colon == std::string::npos) {
+      return total_size;
+    }
+
+    std::string name = line.substr(0, colon);
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    auto start = line.find_first_not_of(" \t", colon + 1);
+    auto end = line.find_last_not_of(" \t\r\n");
+    std::string value = start == std::string::npos || end < start ? "" : line.substr(start, end - start + 1);
+
+    if (name == "etag") {
+      headers->etag = value;
+    }
+    else if (name == "last-modified") {
+      headers->last_modified = value;
+    }
+    else if (name == "retry-after") {
+      // retry-after is either a number of seconds or an http date
+      if (!value.empty() && isdigit((unsigned char)value[0])) {
+        headers->retry_after = strtol(value.c_str(), nullptr, 10);
+      }
+      else {
+        time_t at = curl_getdate(value.c_str(), nullptr);
+        headers->retry_after = at < 0 ? -1 : std::max(0L, (long)(at - time(nullptr)));
+      }
+    }
+    else if (name == "cache-control") {
+      std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+      headers->no_store = headers->no_store || value.find("no-store") != std::string::npos || value.find("private") != std::string::npos;
+      headers->no_cache = headers->no_cache || value.find("no-cache") != std::string::npos;
+
+      auto max_age = value.find("max-age=");
+      if (max_age != std::string::npos) {
+        headers->max_age = strtol(value.c_str() + max_age + 8, nullptr, 10);
+      }
+    }
+
+    return total_size;
+  }
+
+  // check if a failed transfer or an error response is worth another attempt
+  bool is_retryable(CURLcode res, long http_status_code, const response_headers &headers) {
+    if (res != CURLE_OK) {
+      return res == CURLE_COULDNT_RESOLVE_PROXY || res == CURLE_COULDNT_RESOLVE_HOST || res == CURLE_COULDNT_CONNECT;
+    }
+
+    return http_status_code == 502 || http_status_code == 503 || http_status_code == 504 || (http_status_code == 429 && headers.retry_after >= 0);
+  }
+
+  // get delay before given retry, a retry-after header wins over exponential backoff with jitter
+  std::chrono::milliseconds retry_delay(const request_options &options, long retry, const response_headers &headers) {
+    if (headers.retry_after >= 0) {
+      return std::chrono::milliseconds(headers.retry_after * 1000);
+    }
+
+    // random delay in upper half of the backoff, so concurrent callers do not retry in lockstep
+    thread_local std::minstd_rand generator(std::random_device{}());
+    long backoff = options.retry_backoff_ms << std::min(retry, 16L);
+    return std::chrono::milliseconds(backoff / 2 + std::uniform_int_distribution<long>(0, backoff / 2)(generator));
+  }
+
+  // get timeout of the next attempt from remaining time until deadline and given curl timeout options, 0 if time is up
+  long attempt_timeout_ms(const request_template &tmpl, std::chrono::steady_clock::time_point deadline) {
+    long timeout = (long)std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+    if (timeout <= 0) {
+      return 0;
+    }
+
+    if (tmpl.curl_options != nullptr) {
+      for (auto &opt : *tmpl.curl_options) {
+        if (opt.option == CURLOPT_TIMEOUT && opt.long_value > 0) {
+          timeout = std::min(timeout, opt.long_value * 1000);
+        }
+        else if (opt.option == CURLOPT_TIMEOUT_MS && opt.long_value > 0) {
+          timeout = std::min(timeout, opt.long_value);
+        }
+      }
+    }
+    return timeout;
+  }
+
+  // perform a prepared GET request, sending a duplicate on a second pooled handle if it does not finish within hedge delay
+  // the transfer finishing first wins, its response is moved into given buffer and headers and its handle is returned
+  CURL *perform_hedged(CURL *curl, curl_handle_pool *pool, std::unique_ptr<pooled_curl_handle> &hedge_handle, const request_template &tmpl, const char *url, const request_body &body, long hedge_ms, long timeout_ms, response_buffer &response, response_headers &headers, CURLcode &res) {
+    CURLM *multi = curl_multi_init();
+    if (multi == nullptr) {
+      res = curl_easy_perform(curl);
+      return curl;
+    }
+    curl_multi_add_handle(multi, curl);
+
+    auto hedge_at = std::chrono::steady_clock::now() + std::chrono::milliseconds(hedge_ms);
+    CURL *hedge = nullptr;
+    response_buffer hedge_response;
+    response_headers hedge_headers;
+    request_body hedge_body(body.data, body.length);
+    CURL *winner = nullptr;
+    CURL *failed = nullptr;
+    res = CURLE_FAILED_INIT;
+
+    while (winner == nullptr) {
+      int running = 0;
+      if (curl_multi_perform(multi, &running) != CURLM_OK) {
+        winner = curl;
+        break;
+      }
+
+      CURLMsg *msg;
+      int queued;
+      while (winner == nullptr && (msg = curl_multi_info_read(multi, &queued)) != nullptr) {
+        if (msg->msg != CURLMSG_DONE) {
+          continue;
+        }
+
+        // a failed transfer does not end the request while its duplicate is still running
+        if (msg->data.result != CURLE_OK && hedge != nullptr && failed == nullptr) {
+          failed = msg->easy_handle;
+          res = msg->data.result;
+          continue;
+        }
+
+        winner = msg->easy_handle;
+        res = msg->data.result;
+      }
+
+      if (winner != nullptr) {
+        break;
+      }
+
+      auto now = std::chrono::steady_clock::now();
+      if (hedge == nullptr && failed == nullptr && now >= hedge_at) {
+        hedge_handle.reset(new pooled_curl_handle(pool));
+        hedge = hedge_handle->get();
+        if (hedge != nullptr) {
+          setup_request(hedge, tmpl, url, hedge_body);
+          hedge_response.curl = hedge;
+          curl_easy_setopt(hedge, CURLOPT_WRITEFUNCTION, buffer_write_callback);
+          curl_easy_setopt(hedge, CURLOPT_WRITEDATA, &hedge_response);
+          curl_easy_setopt(hedge, CURLOPT_HEADERFUNCTION, header_callback);
+          curl_easy_setopt(hedge, CURLOPT_HEADERDATA, &hedge_headers);
+          if (timeout_ms > 0) {
+            curl_easy_setopt(hedge, CURLOPT_TIMEOUT_MS, timeout_ms);
+          }
+          curl_multi_add_handle(multi, hedge);
+          hedged_requests++;
+        }
+        continue;
+      }
+
+      // wake up for socket activity or to send the hedge in time
+      int wait_ms = hedge == nullptr && failed == nullptr ? (int)std::min<long long>(1000, std::chrono::duration_cast<std::chrono::milliseconds>(hedge_at - now).count() + 1) : 1000;
+      curl_multi_poll(multi, nullptr, 0, wait_ms, nullptr);
+    }
+
+    // the slower transfer is cancelled
+    curl_multi_remove_handle(multi, curl);
+    if (hedge != nullptr) {
+      curl_multi_remove_handle(multi, hedge);
+    }
+    curl_multi_cleanup(multi);
+
+    hedge_response.curl = nullptr;
+    if (winner == hedge) {
+      hedge_wins++;
+      response.swap(hedge_response);
+      headers = hedge_headers;
+    }
+    return winner;
+  }
+
+  // send a prepared request retrying and hedging it as given by request options, every attempt is recorded
+  // returns the handle of the final attempt whose response is left in given buffer and headers
+  CURL *perform_request(CURL *curl, curl_handle_pool *pool, std::unique_ptr<pooled_curl_handle> &hedge_handle, const request_template &tmpl, const char *url, request_body &body, response_buffer &response, response_headers &headers, CURLcode &res, long &http_status_code) {
+    const request_options &options = tmpl.options;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(options.deadline_ms);
+
+    // hedging is only safe for idempotent requests without a body
+    long hedge_ms = tmpl.method == "GET" ? options.hedge_ms : 0;
+    if (hedge_ms < 0) {
+      hedge_ms = (long)(total_latency.percentile(95) / 1000);
+    }
+
+    for (long attempt = 0;; attempt++) {
+      long timeout_ms = 0;
+      if (options.deadline_ms > 0) {
+        timeout_ms = attempt_timeout_ms(tmpl, deadline);
+        if (timeout_ms == 0) {
+          // time is up, result of the last attempt is returned
+          return curl;
+        }
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, timeout_ms);
+      }
+
+      CURL *finished = curl;
+      if (hedge_ms > 0) {
+        finished = perform_hedged(curl, pool, hedge_handle, tmpl, url, body, hedge_ms, timeout_ms, response, headers, res);
+      }
+      else {
+        res = perform_transfer(curl);
+      }
+
+      http_status_code = -1;
+      curl_easy_getinfo(finished, CURLINFO_RESPONSE_CODE, &http_status_code);
+      record_transfer(finished, res, http_status_code, tmpl.method, url);
+
+      if (attempt >= options.retries || response.exceeded || !is_retryable(res, http_status_code, headers)) {
+        return finished;
+      }
+
+      auto delay = retry_delay(options, attempt, headers);
+      if (options.deadline_ms > 0 && std::chrono::steady_clock::now() + delay >= deadline) {
+        return finished;
+      }
+      std::this_thread::sleep_for(delay);
+
+      // a statement killed while waiting is not retried
+      MYSQL_THD thd = nullptr;
+      if (!mysql_service_mysql_current_thread_reader->get(&thd) && statement_killed(thd)) {
+        return finished;
+      }
+
+      retried_requests++;
+      response.clear();
+      response.curl = curl;
+      headers = response_headers();
+
+      // a chunked body is read again from its start
+      body.offset = 0;
+    }
+  }
+
+  // build cache key from method, url, normalized headers and body hash, empty if request is not cacheable
+  std::string make_cache_key(const request_template &tmpl, const char *url, size_t url_length, const char *body, size_t body_length) {
+    if (tmpl.method != "GET") {
+      return std::string();
+    }
+
+    std::vector<std::string> headers;
+    if (tmpl.headers != nullptr) {
+      for (auto item = tmpl.headers->list; item != nullptr; item = item->next) {
+        std::string header = item->data;
+        auto colon = header.find(':');
+        std::transform(header.begin(), colon == std::string::npos ? header.end() : header.begin() + colon, header.begin(), ::tolower);
+
+        // request explicitly bypasses caches
+        if (header.compare(0, 14, "cache-control:") == 0 && (header.find("no-store") != std::string::npos || header.find("no-cache") != std::string::npos)) {
+          return std::string();
+        }
+        headers.push_back(std::move(header));
+      }
+    }
+    std::sort(headers.begin(), headers.end());
+
+    std::string key = tmpl.method + "\n" + std::string(url, url_length);
+    for (auto &header : headers) {
+      key += "\n" + header;
+    }
+
+    if (body != nullptr) {
+      key += "\n" + std::to_string(std::hash<std::string_view>()(std::string_view(body, body_length)));
+    }
+    return key;
+  }
+
+  // add conditional headers to revalidate a stale cached response
+  void add_revalidation_headers(request_template &tmpl, const cached_response &cached) {
+    auto compiled = copy_headers(tmpl);
+
+    if (!cached.etag.empty()) {
+      compiled->list = curl_slist_append(compiled->list, ("If-None-Match: " + cached.etag).c_str());
+    }
+    if (!cached.last_modified.empty()) {
+      compiled->list = curl_slist_append(compiled->list, ("If-Modified-Since: " + cached.last_modified).c_str());
+    }
+
+    tmpl.headers = std::move(compiled);
+  }
+
+  // report a failed request, errors which are not logged with a transfer are logged here
+  const char *request_failed(response_buffer &response, const char *message, long http_status_code, bool logged, char *is_null, char *error) {
+    response.clear();
+
+    if (!logged) {
+      log_error(message);
+    }
+    mysql_error_service_printf(ER_GET_ERRMSG, 0, http_status_code, message, "curl request");
+    *error = 1;
+    *is_null = 1;
+    return 0;
+  }
+
+  // lead a coalesced flight until the response is published, followers send their own requests if it fails
+  class coalescing_lead {
+    private:
+      std::string key;
+      std::shared_ptr<coalesced_flight> flight;
+
+    public:
+      void start(std::string &&flight_key, std::shared_ptr<coalesced_flight> &&led) {
+        key = std::move(flight_key);
+        flight = std::move(led);
+      }
+
+      void publish(const char *body, size_t body_length) {
+        if (flight != nullptr) {
+          my_request_coalescer->finish(key, flight, body != nullptr ? body : "", body_length);
+          flight = nullptr;
+        }
+      }
+
+      ~coalescing_lead() {
+        if (flight != nullptr) {
+          my_request_coalescer->finish(key, flight, nullptr, 0);
+        }
+      }
+  };
+
+  // send a compiled request using handles of given pool and return its response in the buffer of the statement
+  const char *send_request(udf_context *context, request_template &tmpl, const char *url, size_t url_length, const char *body, size_t body_length, curl_handle_pool *pool, unsigned long *length, char *is_null, char *error) {
+    response_buffer &response = context->result;
+    long http_status_code = -1;
+    bool transfer_failed = false;
+
+    try {
+      // serve fresh responses from cache, stale ones are revalidated with a conditional request
+      std::string cache_key;
+      cached_response cached;
+      bool has_cached = false;
+      if (cache_size > 0) {
+        cache_key = make_cache_key(tmpl, url, url_length, body, body_length);
+      }
+
+      if (!cache_key.empty()) {
+        bool fresh = false;
+        has_cached = my_response_cache->get(cache_key, cached, &fresh);
+
+        if (has_cached && fresh) {
+          cache_hits++;
+          record_cache_hit(tmpl.method, url);
+          if (!response.assign(cached.body.data(), cached.body.size())) {
+            throw std::runtime_error("out of memory");
+          }
+          *length = response.size;
+          return response.data;
+        }
+
+        cache_misses++;
+        if (has_cached) {
+          add_revalidation_headers(tmpl, cached);
+        }
+      }
+
+      // wait for an identical request in flight instead of sending another one, a failed or slow one is not waited for again
+      coalescing_lead lead;
+      if (tmpl.options.coalesce_ms > 0) {
+        std::string coalesce_key = cache_key.empty() ? make_cache_key(tmpl, url, url_length, body, body_length) : cache_key;
+        if (!coalesce_key.empty()) {
+          bool leader = false;
+          auto flight = my_request_coalescer->join(coalesce_key, leader);
+          if (leader) {
+            lead.start(std::move(coalesce_key), std::move(flight));
+          }
+          else if (my_request_coalescer->wait(flight, tmpl.options.coalesce_ms)) {
+            coalesced_requests++;
+            if (!response.assign(flight->body.data(), flight->body.size()) || !response.reserve(0)) {
+              throw std::runtime_error("out of memory");
+            }
+            *length = response.size;
+            return response.data;
+          }
+          else {
+            coalesce_fallbacks++;
+          }
+        }
+      }
+
+      std::string encoded;
+      if (encode_body(tmpl, body, body_length, encoded)) {
+        body = encoded.data();
+        body_length = encoded.size();
+      }
+
+      host_permit permit;
+      std::string limit_message;
+      if (!permit.acquire(url, limit_message)) {
+        throw std::runtime_error(limit_message);
+      }
+
+      pooled_curl_handle handle(pool);
+      CURL *curl = handle.get();
+      if (!curl) {
+        throw std::runtime_error("curl init failed");
+      }
+
+      request_body upload(body, body_length);
+      setup_request(curl, tmpl, url, upload);
+
+      // write the response directly into the buffer returned to mysql
+      response.curl = curl;
+      curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, buffer_write_callback);
+      curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+
+      response_headers headers;
+      if (!cache_key.empty() || tmpl.options.retries > 0 || tmpl.options.hedge_ms != 0) {
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, header_callback);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, &headers);
+      }
+
+      // send the request, a hedged duplicate is released when this call returns
+      std::unique_ptr<pooled_curl_handle> hedge_handle;
+      CURLcode res = CURLE_FAILED_INIT;
+      CURL *finished = perform_request(curl, pool, hedge_handle, tmpl, url, upload, response, headers, res, http_status_code);
+      auto end_time = std::chrono::steady_clock::now();
+
+      permit.finish(finished, res, http_status_code);
+      response.curl = nullptr;
+
+      // failed transfer is already logged by record_transfer
+      if (res != CURLE_OK) {
+        auto http_error_message = response.exceeded || res == CURLE_FILESIZE_EXCEEDED ? "response is larger than httpclient.max_response_size" : transfer_error(res);
+        std::string msg = tmpl.method + " " + std::string(url) + " failed with error code " + std::to_string(http_status_code) + ": " + std::string(http_error_message);
+        transfer_failed = true;
+        throw std::runtime_error(msg);
+      }
+
+      if (!cache_key.empty()) {
+        auto expires_at = end_time + std::chrono::seconds(headers.no_cache || headers.max_age < 0 ? 0 : headers.max_age);
+
+        if (has_cached && http_status_code == 304) {
+          // cached body is still valid
+          cache_revalidations++;
+          if (headers.max_age >= 0 || headers.no_cache) {
+            my_response_cache->refresh(cache_key, expires_at);
+          }
+          if (!response.assign(cached.body.data(), cached.body.size())) {
+            throw std::runtime_error("out of memory");
+          }
+          http_status_code = 200;
+        }
+        else if (http_status_code == 200 && !headers.no_store && (headers.max_age > 0 || !headers.etag.empty() || !headers.last_modified.empty())) {
+          cached_response entry;
+          entry.url.assign(url, url_length);
+          entry.body.assign(response.data != nullptr ? response.data : "", response.size);
+          entry.etag = headers.etag;
+          entry.last_modified = headers.last_modified;
+          entry.expires_at = expires_at;
+          my_response_cache->put(cache_key, std::move(entry));
+        }
+      }
+
+      // since message size is possibly bigger than 255, "outp" buffer is not usable
+      // the buffer of this statement is returned as is, an empty body still needs an allocated buffer
+      if (!response.reserve(0)) {
+        throw std::runtime_error("out of memory");
+      }
+      *length = response.size;
+      lead.publish(response.data, response.size);
+    }
+    catch (const std::exception& ex) {
+      return request_failed(response, ex.what(), http_status_code, transfer_failed, is_null, error);
+    }
+
+    return response.data;
+  }
+
+  // perform curl request with given options
+  const char *httpclient_request_udf(UDF_INIT *initid, UDF_ARGS *args, char *, unsigned long *length, char *is_null, char *error) {
+    udf_context *context = reinterpret_cast<udf_context *>(initid->ptr);
+    context->result.clear();
+
+    if (!validate_request(args, is_null, error)) {
+      return 0;
+    }
+
+    request_template tmpl;
+    try {
+      compile_request(context, args, tmpl);
+    }
+    catch (const std::exception& ex) {
+      return request_failed(context->result, ex.what(), -1, false, is_null, error);
+    }
+
+    const char *body = args->arg_count > 2 ? args->args[2] : nullptr;
+    return send_request(context, tmpl, args->args[1], args->lengths[1], body, body != nullptr ? args->lengths[2] : 0, my_curl_handle_pool, length, is_null, error);
+  }
+
+  // initialize function registering a request profile
+  static bool httpclient_profile_set_udf_init(UDF_INIT *, UDF_ARGS *args, char *message) {
+    if (args->arg_count < 2 || args->arg_count > 4) {
+      snprintf(message, MYSQL_ERRMSG_SIZE, "expected NAME, BASE_URL, HEADERS and CURL_OPTIONS arguments");
+      return true;
+    }
+
+    for (unsigned int i = 0; i < args->arg_count; i++) {
+      args->arg_type[i] = STRING_RESULT;
+    }
+    return 0;
+  }
+
+  // register or replace a named profile of base url, headers and curl options, compiled once for all requests using it
+  long long httpclient_profile_set_udf(UDF_INIT *, UDF_ARGS *args, char *is_null, char *error) {
+    MYSQL_THD thd;
+    mysql_service_mysql_current_thread_reader->get(&thd);
+
+    if (!has_privilege(thd)) {
+      mysql_error_service_printf(ER_SPECIFIC_ACCESS_DENIED_ERROR, 0, HTTPCLIENT_PRIVILEGE_NAME);
+      *error = 1;
+      *is_null = 1;
+      return 0;
+    }
+
+    if (args->args[0] == nullptr || args->args[1] == nullptr) {
+      mysql_error_service_printf(ER_UDF_ERROR, 0, "http_profile_set", "name and base url must not be null");
+      *error = 1;
+      *is_null = 1;
+      return 0;
+    }
+
+    try {
+      auto profile = std::make_shared<request_profile>();
+      profile->name.assign(args->args[0], args->lengths[0]);
+      profile->base_url.assign(args->args[1], args->lengths[1]);
+      compile_method(nullptr, profile->tmpl);
+      compile_headers(args->arg_count > 2 ? args->args[2] : nullptr, profile->tmpl);
+      compile_curl_options(args->arg_count > 3 ? args->args[3] : nullptr, profile->tmpl);
+      my_profile_registry->set(std::move(profile));
+    }
+    catch (const std::exception& ex) {
+      mysql_error_service_printf(ER_UDF_ERROR, 0, "http_profile_set", ex.what());
+      *error = 1;
+      *is_null = 1;
+      return 0;
+    }
+
+    return 1;
+  }
+
+  // initialize function removing a request profile
+  static bool httpclient_profile_drop_udf_init(UDF_INIT *, UDF_ARGS *args, char *message) {
+    if (args->arg_count != 1) {
+      snprintf(message, MYSQL_ERRMSG_SIZE, "expected a single profile name argument");
+      return true;
+    }
+
+    args->arg_type[0] = STRING_RESULT;
+    return 0;
+  }
+
+  // remove a named profile, requests already using it finish with it
+  long long httpclient_profile_drop_udf(UDF_INIT *, UDF_ARGS *args, char *is_null, char *error) {
+    MYSQL_THD thd;
+    mysql_service_mysql_current_thread_reader->get(&thd);
+
+    if (!has_privilege(thd)) {
+      mysql_error_service_printf(ER_SPECIFIC_ACCESS_DENIED_ERROR, 0, HTTPCLIENT_PRIVILEGE_NAME);
+      *error = 1;
+      *is_null = 1;
+      return 0;
+    }
+
+    if (args->args[0] == nullptr) {
+      *is_null = 1;
+      return 0;
+    }
+
+    return my_profile_registry->drop(std::string(args->args[0], args->lengths[0])) ? 1 : 0;
+  }
+
+  // initialize function sending requests of a profile
+  static bool httpclient_request_profile_udf_init(UDF_INIT *initid, UDF_ARGS *args, char *message) {
+    if (args->arg_count < 2 || args->arg_count > 4) {
+      snprintf(message, MYSQL_ERRMSG_SIZE, "expected PROFILE, METHOD, PATH and BODY arguments");
+      return true;
+    }
+
+    for (unsigned int i = 0; i < args->arg_count; i++) {
+      args->arg_type[i] = STRING_RESULT;
+    }
+
+    const char* name = "utf8mb4";
+    char *value = const_cast<char*>(name);
+    if (mysql_service_mysql_udf_metadata->result_set(initid, "charset", const_cast<char *>(value))) {
+      LogComponentErr(ERROR_LEVEL, ER_LOG_PRINTF_MSG, "failed to set result charset");
+    }
+
+    udf_context *context = new udf_context();
+    if (args->args[1] != nullptr) {
+      compile_method(args->args[1], context->constant);
+      context->constant_method = true;
+    }
+
+    context->result.reserve(16 * 1024);
+    initid->ptr = reinterpret_cast<char *>(context);
+    return false;
+  }
+
+  // send a request with base url, headers and curl options of a profile, only method, path and body are given per call
+  const char *httpclient_request_profile_udf(UDF_INIT *initid, UDF_ARGS *args, char *, unsigned long *length, char *is_null, char *error) {
+    udf_context *context = reinterpret_cast<udf_context *>(initid->ptr);
+    context->result.clear();
+
+    MYSQL_THD thd;
+    mysql_service_mysql_current_thread_reader->get(&thd);
+
+    if (!has_privilege(thd)) {
+      mysql_error_service_printf(ER_SPECIFIC_ACCESS_DENIED_ERROR, 0, HTTPCLIENT_PRIVILEGE_NAME);
+      *error = 1;
+      *is_null = 1;
+      return 0;
+    }
+
+    if (args->args[0] == nullptr) {
+      mysql_error_service_printf(ER_UDF_ERROR, 0, "http_request_profile", "profile must not be null");
+      *error = 1;
+      *is_null = 1;
+      return 0;
+    }
+
+    // the profile is kept alive by this request even if it is replaced or dropped meanwhile
+    std::string profile_name(args->args[0], args->lengths[0]);
+    auto profile = my_profile_registry->get(profile_name);
+    if (profile == nullptr) {
+      return request_failed(context->result, ("profile " + profile_name + " does not exist").c_str(), -1, false, is_null, error);
+    }
+
+    request_template tmpl = profile->tmpl;
+    if (context->constant_method) {
+      tmpl.method = context->constant.method;
+    }
+    else {
+      compile_method(args->args[1], tmpl);
+    }
+
+    std::string url = profile->base_url;
+    if (args->arg_count > 2 && args->args[2] != nullptr) {
+      url.append(args->args[2], args->lengths[2]);
+    }
+
+    const char *body = args->arg_count > 3 ? args->args[3] : nullptr;
+    return send_request(context, tmpl, url.c_str(), url.size(), body, body != nullptr ? args->lengths[3] : 0, profile->pool.get(), length, is_null, error);
+  }
+
+  // initialize function invalidating cached responses
+  static bool httpclient_cache_invalidate_udf_init(UDF_INIT *, UDF_ARGS *args, char *message) {
+    if (args->arg_count != 1) {
+      snprintf(message, MYSQL_ERRMSG_SIZE, "expected a single url prefix argument");
+      return true;
+    }
+
+    args->arg_type[0] = STRING_RESULT;
+    return 0;
+  }
+
+  // remove cached responses of urls starting with given prefix and return number of removed responses
+  long long httpclient_cache_invalidate_udf(UDF_INIT *, UDF_ARGS *args, char *is_null, char *error) {
+    MYSQL_THD thd;
+    mysql_service_mysql_current_thread_reader->get(&thd);
+
+    if (!has_privilege(thd)) {
+      mysql_error_service_printf(ER_SPECIFIC_ACCESS_DENIED_ERROR, 0, HTTPCLIENT_PRIVILEGE_NAME);
+      *error = 1;
+      *is_null = 1;
+      return 0;
+    }
+
+    if (args->args[0] == nullptr) {
+      *is_null = 1;
+      return 0;
+    }
+
+    return (long long)my_response_cache->invalidate(std::string(args->args[0], args->lengths[0]));
+  }
+
+  // initialize function setting limits of a host
+  static bool httpclient_host_limit_udf_init(UDF_INIT *, UDF_ARGS *args, char *message) {
+    if (args->arg_count != 3) {
+      snprintf(message, MYSQL_ERRMSG_SIZE, "expected HOST, MAX_IN_FLIGHT and REQUESTS_PER_SECOND arguments");
+      return true;
+    }
+
+    args->arg_type[0] = STRING_RESULT;
+    args->arg_type[1] = INT_RESULT;
+    args->arg_type[2] = INT_RESULT;
+    return 0;
+  }
+
+  // set concurrency and rate limit of a host, null limits fall back to system variables
+  long long httpclient_host_limit_udf(UDF_INIT *, UDF_ARGS *args, char *is_null, char *error) {
+    MYSQL_THD thd;
+    mysql_service_mysql_current_thread_reader->get(&thd);
+
+    if (!has_privilege(thd)) {
+      mysql_error_service_printf(ER_SPECIFIC_ACCESS_DENIED_ERROR, 0, HTTPCLIENT_PRIVILEGE_NAME);
+      *error = 1;
+      *is_null = 1;
+      return 0;
+    }
+
+    if (args->args[0] == nullptr) {
+      mysql_error_service_printf(ER_UDF_ERROR, 0, "http_host_limit", "host must not be null");
+      *error = 1;
+      *is_null = 1;
+      return 0;
+    }
+
+    std::string host(args->args[0], args->lengths[0]);
+    std::transform(host.begin(), host.end(), host.begin(), ::tolower);
+    long max_in_flight = args->args[1] != nullptr ? (long)std::max(0LL, *reinterpret_cast<long long *>(args->args[1])) : -1;
+    long rate_limit = args->args[2] != nullptr ? (long)std::max(0LL, *reinterpret_cast<long long *>(args->args[2])) : -1;
+
+    my_host_registry->set_limits(host, max_in_flight, rate_limit);
+    return 1;
+  }
+
+  // size of the buffer collecting response data before it is written to a file
+  static const size_t file_write_buffer_size = 256 * 1024;
+
+  // compute crc32 of given bytes continuing from a previous checksum, same as CRC32() of mysql
+  uint32_t crc32_update(uint32_t crc, const char *bytes, size_t length) {
+    static const auto table = [] {
+      std::array<uint32_t, 256> values{};
+      for (uint32_t i = 0; i < 256; i++) {
+        uint32_t value = i;
+        for (int bit = 0; bit < 8; bit++) {
+          value = (value & 1) ? 0xEDB88320 ^ (value >> 1) : value >> 1;
+        }
+        values[i] = value;
+      }
+      return values;
+    }();
+
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+      crc = table[(crc ^ static_cast<unsigned char>(bytes[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+  }
+
+  // write all given bytes to a file descriptor
+  bool write_all(int fd, const char *bytes, size_t length) {
+    while (length > 0) {
+      ssize_t written = write(fd, bytes, length);
+      if (written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return false;
+      }
+
+      bytes += written;
+      length -= (size_t)written;
+    }
+    return true;
+  }
+
+  // define the file a response is streamed to, data is collected in a bounded buffer and written in large chunks
+  struct file_sink {
+    int fd = -1;
+    response_buffer *buffer = nullptr;
+    unsigned long long bytes = 0;
+    uint32_t crc = 0;
+    int error = 0;
+
+    bool flush() {
+      if (buffer->size > 0 && !write_all(fd, buffer->data, buffer->size)) {
+        error = errno;
+        return false;
+      }
+
+      buffer->clear();
+      return true;
+    }
+  };
+
+  // curl write function streaming the response to a file
+  size_t file_write_callback(void *contents, size_t size, size_t nmemb, void *userp) {
+    size_t total_size = size * nmemb;
+    file_sink *sink = static_cast<file_sink *>(userp);
+    const char *bytes = static_cast<const char *>(contents);
+
+    sink->crc = crc32_update(sink->crc, bytes, total_size);
+    sink->bytes += total_size;
+
+    if (sink->buffer->size + total_size > file_write_buffer_size && !sink->flush()) {
+      return 0;
+    }
+
+    // chunks larger than the buffer are written as is
+    if (total_size >= file_write_buffer_size) {
+      if (!write_all(sink->fd, bytes, total_size)) {
+        sink->error = errno;
+        return 0;
+      }
+      return total_size;
+    }
+
+    sink->buffer->append(bytes, total_size);
+    return total_size;
+  }
+
+  // resolve path of a new file and check that it is inside secure_file_priv directory
+  bool resolve_output_file(const char *file, size_t file_length, std::string &path, std::string &message) {
+    std::string requested(file, file_length);
+    auto separator = requested.find_last_of('/');
+    if (requested.empty() || requested[0] != '/' || separator == requested.size() - 1) {
+      message = "file must be an absolute path of a file";
+      return false;
+    }
+
+    char directory[PATH_MAX];
+    std::string parent = separator == 0 ? "/" : requested.substr(0, separator);
+    if (realpath(parent.c_str(), directory) == nullptr) {
+      message = "directory of " + requested + " does not exist";
+      return false;
+    }
+
+    // file operations are disabled if secure_file_priv is null, an empty value allows any directory
+    char value_buffer[PATH_MAX];
+    char *value = value_buffer;
+    size_t value_length = sizeof(value_buffer) - 1;
+    if (mysql_service_component_sys_variable_register->get_variable("mysql_server", "secure_file_priv", reinterpret_cast<void **>(&value), &value_length)) {
+      message = "file operations are disabled by secure_file_priv";
+      return false;
+    }
+
+    if (value_length > 0) {
+      char allowed[PATH_MAX];
+      std::string secure_file_priv(value, value_length);
+      if (realpath(secure_file_priv.c_str(), allowed) == nullptr) {
+        message = "secure_file_priv directory does not exist";
+        return false;
+      }
+
+      std::string allowed_prefix = allowed;
+      if (allowed_prefix.back() != '/') {
+        allowed_prefix += '/';
+      }
+
+      if ((std::string(directory) + "/").compare(0, allowed_prefix.size(), allowed_prefix) != 0) {
+        message = "file must be inside secure_file_priv directory";
+        return false;
+      }
+    }
+
+    path = directory;
+    if (path.back() != '/') {
+      path += '/';
+    }
+    path += requested.substr(separator + 1);
+    return true;
+  }
+
+  // view arguments following the first argument (FILE or PATHS) as arguments of a regular request
+  UDF_ARGS request_arguments(UDF_ARGS *args) {
+    UDF_ARGS request_args = *args;
+    request_args.arg_count = args->arg_count - 1;
+    request_args.arg_type = args->arg_type + 1;
+    request_args.args = args->args + 1;
+    request_args.lengths = args->lengths + 1;
+    request_args.maybe_null = args->maybe_null + 1;
+    request_args.attributes = args->attributes + 1;
+    request_args.attribute_lengths = args->attribute_lengths + 1;
+    return request_args;
+  }
+
+  // initialize function streaming responses to files
+  static bool httpclient_to_file_udf_init(UDF_INIT *initid, UDF_ARGS *args, char *message) {
+    if (args->arg_count < 3) {
+      snprintf(message, MYSQL_ERRMSG_SIZE, "expected FILE, METHOD and URL arguments");
+      return true;
+    }
+    args->arg_type[0] = STRING_RESULT;
+
+    const char* name = "utf8mb4";
+    char *value = const_cast<char*>(name);
+    if (mysql_service_mysql_udf_metadata->result_set(initid, "charset", const_cast<char *>(value))) {
+      LogComponentErr(ERROR_LEVEL, ER_LOG_PRINTF_MSG, "failed to set result charset");
+    }
+
+    UDF_ARGS request_args = request_arguments(args);
+    if (create_request_context(initid, &request_args, message)) {
+      return true;
+    }
+
+    // the response buffer of the statement is used as write buffer
+    reinterpret_cast<udf_context *>(initid->ptr)->result.reserve(file_write_buffer_size);
+    return false;
+  }
+
+  // send a request and stream its response to a new file, returns status, bytes written and crc32 of the file
+  const char *httpclient_request_to_file_udf(UDF_INIT *initid, UDF_ARGS *args, char *, unsigned long *length, char *is_null, char *error) {
+    udf_context *context = reinterpret_cast<udf_context *>(initid->ptr);
+    response_buffer &buffer = context->result;
+    buffer.clear();
+
+    UDF_ARGS request_args = request_arguments(args);
+    if (!validate_request(&request_args, is_null, error)) {
+      return 0;
+    }
+
+    if (args->args[0] == nullptr) {
+      mysql_error_service_printf(ER_UDF_ERROR, 0, "http_request_to_file", "file must not be null");
+      *error = 1;
+      *is_null = 1;
+      return 0;
+    }
+
+    const char *url = request_args.args[1];
+    const char *body = request_args.arg_count > 2 ? request_args.args[2] : nullptr;
+    size_t body_length = body != nullptr ? request_args.lengths[2] : 0;
+
+    long http_status_code = -1;
+    std::string path;
+    bool created = false;
+    bool transfer_failed = false;
+    file_sink sink;
+    sink.buffer = &buffer;
+
+    try {
+      request_template tmpl;
+      compile_request(context, &request_args, tmpl);
+
+      std::string message;
+      if (!resolve_output_file(args->args[0], args->lengths[0], path, message)) {
+        throw std::runtime_error(message);
+      }
+
+      // never overwrite existing files, same as SELECT ... INTO OUTFILE
+      sink.fd = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0640);
+      if (sink.fd < 0) {
+        throw std::runtime_error("failed to create " + path + ": " + strerror(errno));
+      }
+      created = true;
+
+      if (!buffer.reserve(file_write_buffer_size)) {
+        throw std::runtime_error("out of memory");
+      }
+
+      std::string encoded;
+      if (encode_body(tmpl, body, body_length, encoded)) {
+        body = encoded.data();
+        body_length = encoded.size();
+      }
+
+      host_permit permit;
+      std::string limit_message;
+      if (!permit.acquire(url, limit_message)) {
+        throw std::runtime_error(limit_message);
+      }
+
+      pooled_curl_handle handle;
+      CURL *curl = handle.get();
+      if (!curl) {
+        throw std::runtime_error("curl init failed");
+      }
+
+      request_body upload(body, body_length);
+      setup_request(curl, tmpl, url, upload, false);
+      curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, file_write_callback);
+      curl_easy_setopt(curl, CURLOPT_WRITEDATA, &sink);
+
+      // send the request
+      CURLcode res = perform_transfer(curl);
+
+      curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_status_code);
+      record_transfer(curl, res, http_status_code, tmpl.method, url);
+      permit.finish(curl, res, http_status_code);
+
+      if (res == CURLE_OK && !sink.flush()) {
+        res = CURLE_WRITE_ERROR;
+      }
+
+      if (res != CURLE_OK) {
+        std::string http_error_message = sink.error != 0 ? "failed to write " + path + ": " + strerror(sink.error) : transfer_error(res);
+        std::string msg = tmpl.method + " " + std::string(url) + " failed with error code " + std::to_string(http_status_code) + ": " + http_error_message;
+        transfer_failed = res != CURLE_WRITE_ERROR || sink.error == 0;
+        throw std::runtime_error(msg);
+      }
+
+      if (tmpl.options.fsync && fsync(sink.fd) != 0) {
+        throw std::runtime_error("failed to sync " + path + ": " + strerror(errno));
+      }
+
+      int fd = sink.fd;
+      sink.fd = -1;
+      if (close(fd) != 0) {
+        throw std::runtime_error("failed to close " + path + ": " + strerror(errno));
+      }
+
+      json summary = {{"status", http_status_code}, {"bytes", sink.bytes}, {"crc32", sink.crc}, {"file", path}};
+      std::string response = summary.dump();
+      if (!buffer.assign(response.data(), response.size())) {
+        throw std::runtime_error("out of memory");
+      }
+      *length = buffer.size;
+    }
+    catch (const std::exception& ex) {
+      // remove partially written file, so it can not be loaded by mistake
+      if (sink.fd >= 0) {
+        close(sink.fd);
+      }
+      if (created) {
+        unlink(path.c_str());
+      }
+      buffer.clear();
+
+      if (!transfer_failed) {
+        log_error(ex.what());
+      }
+      mysql_error_service_printf(ER_GET_ERRMSG, 0, http_status_code, ex.what(), "curl request");
+      *error = 1;
+      *is_null = 1;
+      return 0;
+    }
+
+    return buffer.data;
+  }
+
+  // open connections to the origin of given url ahead of requests and return number of connections opened
+  // a HEAD request is sent on each connection concurrently, so each one opens its own connection which then stays in the shared connection cache
+  long preconnect(const char *url, long connections, const std::atomic<bool> &stopping) {
+    CURLM *multi = curl_multi_init();
+    if (multi == nullptr) {
+      return 0;
+    }
+
+    // open separate connections instead of multiplexing http/2 streams on a single one
+    curl_multi_setopt(multi, CURLMOPT_PIPELINING, (long)CURLPIPE_NOTHING);
+
+    std::vector<CURL *> handles;
+    for (long i = 0; i < connections; i++) {
+      CURL *curl = my_curl_handle_pool->acquire();
+      if (curl == nullptr) {
+        break;
+      }
+
+      curl_easy_setopt(curl, CURLOPT_URL, url);
+      curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+      curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, 10000L);
+      curl_multi_add_handle(multi, curl);
+      handles.push_back(curl);
+    }
+
+    long opened = 0;
+    int running = (int)handles.size();
+    while (running > 0 && !stopping) {
+      if (curl_multi_perform(multi, &running) != CURLM_OK) {
+        break;
+      }
+
+      // any response keeps the connection open, only transfer errors count as failures
+      CURLMsg *msg;
+      int queued;
+      while ((msg = curl_multi_info_read(multi, &queued)) != nullptr) {
+        if (msg->msg == CURLMSG_DONE && msg->data.result == CURLE_OK) {
+          opened++;
+        }
+      }
+
+      if (running > 0) {
+        curl_multi_poll(multi, nullptr, 0, 100, nullptr);
+      }
+    }
+
+    for (auto curl : handles) {
+      curl_multi_remove_handle(multi, curl);
+      my_curl_handle_pool->release(curl);
+    }
+    curl_multi_cleanup(multi);
+
+    preconnected += opened;
+    return opened;
+  }
+
+  // open connections to origins listed in httpclient.preconnect from a background thread once the component is installed
+  class startup_preconnector {
+    private:
+      std::thread worker;
+      std::atomic<bool> stopping{false};
+
+    public:
+      void start(const char *urls) {
+        if (urls == nullptr || urls[0] == '\0') {
+          return;
+        }
+
+        std::string list(urls);
+        worker = std::thread([this, list]() {
+          std::stringstream stream(list);
+          std::string url;
+          while (std::getline(stream, url, ',') && !stopping) {
+            auto first = url.find_first_not_of(" \t");
+            auto last = url.find_last_not_of(" \t");
+            if (first == std::string::npos) {
+              continue;
+            }
+
+            url = url.substr(first, last - first + 1);
+            long opened = preconnect(url.c_str(), preconnect_connections, stopping);
+            if (opened < (long)preconnect_connections && !stopping) {
+              LogComponentErr(WARNING_LEVEL, ER_LOG_PRINTF_MSG, ("opened " + std::to_string(opened) + " of " + std::to_string(preconnect_connections) + " connections to " + url).c_str());
+            }
+          }
+        });
+      }
+
+      // cancel connections in progress and wait for the thread
+      void stop() {
+        stopping = true;
+        if (worker.joinable()) {
+          worker.join();
+        }
+      }
+  };
+  startup_preconnector *my_startup_preconnector;
+
+  // initialize function opening connections ahead of requests
+  static bool httpclient_preconnect_udf_init(UDF_INIT *, UDF_ARGS *args, char *message) {
+    if (args->arg_count < 1 || args->arg_count > 2) {
+      snprintf(message, MYSQL_ERRMSG_SIZE, "expected URL and CONNECTIONS arguments");
+      return true;
+    }
+
+    args->arg_type[0] = STRING_RESULT;
+    if (args->arg_count > 1) {
+      args->arg_type[1] = INT_RESULT;
+    }
+    return 0;
+  }
+
+  // resolve, connect and complete tls handshake of connections to the origin of given url, returns number of connections opened
+  long long httpclient_preconnect_udf(UDF_INIT *, UDF_ARGS *args, char *is_null, char *error) {
+    MYSQL_THD thd;
+    mysql_service_mysql_current_thread_reader->get(&thd);
+
+    if (!has_privilege(thd)) {
+      mysql_error_service_printf(ER_SPECIFIC_ACCESS_DENIED_ERROR, 0, HTTPCLIENT_PRIVILEGE_NAME);
+      *error = 1;
+      *is_null = 1;
+      return 0;
+    }
+
+    if (args->args[0] == nullptr) {
+      mysql_error_service_printf(ER_UDF_ERROR, 0, "http_preconnect", "url must not be null");
+      *error = 1;
+      *is_null = 1;
+      return 0;
+    }
+
+    // connections are limited to pool size, idle connections above it would be closed right away
+    long long connections = args->arg_count > 1 && args->args[1] != nullptr ? *reinterpret_cast<long long *>(args->args[1]) : preconnect_connections;
+    connections = std::min<long long>(std::max<long long>(connections, 0), std::max(connection_pool_size, 5U));
+
+    std::string url(args->args[0], args->lengths[0]);
+    std::atomic<bool> stopping{false};
+    return preconnect(url.c_str(), (long)connections, stopping);
+  }
+
+  // define a step of a json path, a member name or an array index
+  struct json_path_step {
+    bool is_index;
+    std::string key;
+    size_t index;
+  };
+
+  // parse a json path of member and array index steps like $.products[0].title or $."a b"["c"]
+  void parse_json_path(const std::string &path, std::vector<json_path_step> &steps) {
+    size_t i = 0;
+    auto fail = [&path]() {
+      throw std::runtime_error("unsupported json path " + path + ", only member and array index steps are supported");
+    };
+
+    while (i < path.size() && isspace((unsigned char)path[i])) {
+      i++;
+    }
+    if (i >= path.size() || path[i] != '$') {
+      fail();
+    }
+    i++;
+
+    // read a quoted member name starting at given position
+    auto read_quoted = [&](std::string &key) {
+      i++;
+      while (i < path.size() && path[i] != '"') {
+        if (path[i] == '\\' && i + 1 < path.size()) {
+          i++;
+        }
+        key.push_back(path[i++]);
+      }
+      if (i >= path.size()) {
+        fail();
+      }
+      i++;
+    };
+
+    while (i < path.size()) {
+      json_path_step step{false, std::string(), 0};
+
+      if (path[i] == '.') {
+        i++;
+        if (i < path.size() && path[i] == '"') {
+          read_quoted(step.key);
+        }
+        else {
+          while (i < path.size() && path[i] != '.' && path[i] != '[' && !isspace((unsigned char)path[i])) {
+            step.key.push_back(path[i++]);
+          }
+        }
+        if (step.key.empty() || step.key == "*") {
+          fail();
+        }
+      }
+      else if (path[i] == '[') {
+        i++;
+        if (i < path.size() && path[i] == '"') {
+          read_quoted(step.key);
+        }
+        else if (i < path.size() && isdigit((unsigned char)path[i])) {
+          step.is_index = true;
+          while (i < path.size() && isdigit((unsigned char)path[i])) {
+            step.index = step.index * 10 + (path[i++] - '0');
+          }
+        }
+        else {
+          fail();
+        }
+        if (i >= path.size() || path[i] != ']') {
+          fail();
+        }
+        i++;
+      }
+      else if (isspace((unsigned char)path[i])) {
+        i++;
+        continue;
+      }
+      else {
+        fail();
+      }
+
+      steps.push_back(std::move(step));
+    }
+  }
+
+  // extract values of json paths from a json document given in chunks as it is received
+  // only containers on the way to a path are tokenized, other values are skipped by matching brackets and quotes
+  // values are kept as raw json text, extraction stops as soon as all paths are resolved
+  class json_extractor {
+    private:
+      enum states { EXPECT_VALUE, EXPECT_KEY, IN_KEY, EXPECT_COLON, IN_STRING, IN_SCALAR, AFTER_VALUE, SKIP };
+
+      struct frame {
+        bool is_object;
+        size_t index;
+        std::string key;
+      };
+
+      std::vector<std::vector<json_path_step>> paths;
+      std::vector<std::string> values;
+      std::vector<bool> found;
+      size_t remaining;
+
+      std::vector<frame> frames;
+      states state = EXPECT_VALUE;
+      bool escaped = false;
+      bool complete = false;
+      bool invalid = false;
+
+      // nesting of a skipped or captured container
+      size_t skip_depth = 0;
+      bool skip_in_string = false;
+
+      // path whose value is being captured, -1 if none
+      long capture = -1;
+
+      // find an unresolved path ending at current position, prefix is set if a path continues below it
+      long match(bool &prefix) const {
+        prefix = false;
+        for (size_t i = 0; i < paths.size(); i++) {
+          auto &steps = paths[i];
+          if (found[i] || steps.size() < frames.size()) {
+            continue;
+          }
+
+          bool equal = true;
+          for (size_t depth = 0; depth < frames.size() && equal; depth++) {
+            auto &f = frames[depth];
+            equal = f.is_object ? !steps[depth].is_index && steps[depth].key == f.key : steps[depth].is_index && steps[depth].index == f.index;
+          }
+
+          if (equal && steps.size() == frames.size()) {
+            return (long)i;
+          }
+          prefix = prefix || equal;
+        }
+        return -1;
+      }
+
+      void begin_value(char c) {
+        bool prefix;
+        capture = match(prefix);
+        if (capture >= 0) {
+          values[capture].clear();
+          values[capture].push_back(c);
+        }
+
+        if (c == '{' || c == '[') {
+          // a captured container or one without any path below it is not tokenized
+          if (capture >= 0 || !prefix) {
+            state = SKIP;
+            skip_depth = 1;
+            skip_in_string = false;
+            escaped = false;
+            return;
+          }
+
+          frames.push_back(frame{c == '{', 0, std::string()});
+          state = c == '{' ? EXPECT_KEY : EXPECT_VALUE;
+          return;
+        }
+
+        // numbers and literals start with a digit, minus or a letter of true, false and null
+        if (c != '"' && c != '-' && !isdigit((unsigned char)c) && c != 't' && c != 'f' && c != 'n') {
+          invalid = true;
+          return;
+        }
+
+        escaped = false;
+        state = c == '"' ? IN_STRING : IN_SCALAR;
+      }
+
+      void end_value() {
+        if (capture >= 0) {
+          found[capture] = true;
+          remaining--;
+          capture = -1;
+        }
+
+        state = AFTER_VALUE;
+        complete = frames.empty() || remaining == 0;
+      }
+
+      void close_container(char c) {
+        if (frames.back().is_object != (c == '}')) {
+          invalid = true;
+          return;
+        }
+        frames.pop_back();
+        end_value();
+      }
+
+    public:
+      explicit json_extractor(std::vector<std::vector<json_path_step>> &&json_paths) : paths(std::move(json_paths)), values(paths.size()), found(paths.size(), false), remaining(paths.size()) {}
+
+      // check if no more input is needed
+      bool done() const {
+        return complete || invalid;
+      }
+
+      bool is_valid() const {
+        return !invalid;
+      }
+
+      // process a chunk of the document, returns false once no more input is needed
+      bool feed(const char *data, size_t size) {
+        for (size_t i = 0; i < size && !done(); i++) {
+          char c = data[i];
+
+          switch (state) {
+            case SKIP:
+              if (capture >= 0) {
+                values[capture].push_back(c);
+              }
+              if (skip_in_string) {
+                if (escaped) {
+                  escaped = false;
+                }
+                else if (c == '\\') {
+                  escaped = true;
+                }
+                else if (c == '"') {
+                  skip_in_string = false;
+                }
+              }
+              else if (c == '"') {
+                skip_in_string = true;
+              }
+              else if (c == '{' || c == '[') {
+                skip_depth++;
+              }
+              else if ((c == '}' || c == ']') && --skip_depth == 0) {
+                end_value();
+              }
+              break;
+
+            case IN_STRING:
+              if (capture >= 0) {
+                values[capture].push_back(c);
+              }
+              if (escaped) {
+                escaped = false;
+              }
+              else if (c == '\\') {
+                escaped = true;
+              }
+              else if (c == '"') {
+                end_value();
+              }
+              break;
+
+            case IN_KEY:
+              if (escaped) {
+                // member names are compared after decoding simple escapes
+                frames.back().key.push_back(c == 'n' ? '\n' : c == 't' ? '\t' : c == 'r' ? '\r' : c == 'b' ? '\b' : c == 'f' ? '\f' : c);
+                escaped = false;
+              }
+              else if (c == '\\') {
+                escaped = true;
+              }
+              else if (c == '"') {
+                state = EXPECT_COLON;
+              }
+              else {
+                frames.back().key.push_back(c);
+              }
+              break;
+
+            case IN_SCALAR:
+              if (!isspace((unsigned char)c) && c != ',' && c != '}' && c != ']') {
+                if (capture >= 0) {
+                  values[capture].push_back(c);
+                }
+                break;
+              }
+
+              // the delimiter ending a number or literal belongs to its container
+              end_value();
+              if (done()) {
+                break;
+              }
+              // fall through
+
+            default:
+              if (isspace((unsigned char)c)) {
+                break;
+              }
+
+              if (state == EXPECT_VALUE) {
+                if (c == ']' && !frames.empty() && !frames.back().is_object && frames.back().index == 0) {
+                  close_container(c);
+                }
+                else if (c == '}' || c == ']' || c == ',' || c == ':') {
+                  invalid = true;
+                }
+                else {
+                  begin_value(c);
+                }
+              }
+              else if (state == EXPECT_KEY) {
+                if (c == '"') {
+                  frames.back().key.clear();
+                  state = IN_KEY;
+                  escaped = false;
+                }
+                else if (c == '}') {
+                  close_container(c);
+                }
+                else {
+                  invalid = true;
+                }
+              }
+              else if (state == EXPECT_COLON) {
+                if (c == ':') {
+                  state = EXPECT_VALUE;
+                }
+                else {
+                  invalid = true;
+                }
+              }
+              else if (state == AFTER_VALUE) {
+                if (c == ',') {
+                  if (frames.back().is_object) {
+                    state = EXPECT_KEY;
+                  }
+                  else {
+                    frames.back().index++;
+                    state = EXPECT_VALUE;
+                  }
+                }
+                else if (c == '}' || c == ']') {
+                  close_container(c);
+                }
+                else {
+                  invalid = true;
+                }
+              }
+              break;
+          }
+        }
+
+        return !done();
+      }
+
+      // end of the document, a number or literal at top level ends here
+      void finish() {
+        if (state == IN_SCALAR) {
+          end_value();
+        }
+        else if (!done()) {
+          invalid = true;
+        }
+      }
+
+      // get raw json value of a path, paths below another captured path are resolved from its value
+      bool get(size_t i, std::string &value) const {
+        if (found[i]) {
+          value = values[i];
+          return true;
+        }
+
+        for (size_t j = 0; j < paths.size(); j++) {
+          if (!found[j] || paths[j].size() >= paths[i].size() || !std::equal(paths[j].begin(), paths[j].end(), paths[i].begin(), [](const json_path_step &a, const json_path_step &b) { return a.is_index == b.is_index && a.key == b.key && a.index == b.index; })) {
+            continue;
+          }
+
+          json node = json::parse(values[j], nullptr, false);
+          const json *current = &node;
+          for (size_t depth = paths[j].size(); depth < paths[i].size() && current != nullptr; depth++) {
+            auto &step = paths[i][depth];
+            if (step.is_index) {
+              current = current->is_array() && step.index < current->size() ? &(*current)[step.index] : nullptr;
+            }
+            else {
+              auto it = current->is_object() ? current->find(step.key) : current->end();
+              current = current->is_object() && it != current->end() ? &*it : nullptr;
+            }
+          }
+
+          if (current != nullptr && !current->is_discarded()) {
+            value = current->dump();
+            return true;
+          }
+        }
+        return false;
+      }
+
+      size_t size() const {
+        return paths.size();
+      }
+  };
+
+  // curl write function feeding a json extractor, stops the transfer once all paths are resolved
+  size_t json_extract_callback(void *contents, size_t size, size_t nmemb, void *userp) {
+    size_t total_size = size * nmemb;
+    json_extractor *extractor = static_cast<json_extractor *>(userp);
+    extractor->feed(static_cast<const char *>(contents), total_size);
+    return extractor->done() ? 0 : total_size;
+  }
+
+  // initialize function extracting json paths from responses
+  static bool httpclient_json_extract_udf_init(UDF_INIT *initid, UDF_ARGS *args, char *message) {
+    if (args->arg_count < 3) {
+      snprintf(message, MYSQL_ERRMSG_SIZE, "expected PATHS, METHOD and URL arguments");
+      return true;
+    }
+    args->arg_type[0] = STRING_RESULT;
+
+    const char* name = "utf8mb4";
+    char *value = const_cast<char*>(name);
+    if (mysql_service_mysql_udf_metadata->result_set(initid, "charset", const_cast<char *>(value))) {
+      LogComponentErr(ERROR_LEVEL, ER_LOG_PRINTF_MSG, "failed to set result charset");
+    }
+
+    UDF_ARGS request_args = request_arguments(args);
+    return create_request_context(initid, &request_args, message);
+  }
+
+  // send a request and return values of given json paths in its response without keeping the whole body
+  // PATHS is a single path returning its value or a json array of paths returning a json array of values
+  const char *httpclient_json_extract_udf(UDF_INIT *initid, UDF_ARGS *args, char *, unsigned long *length, char *is_null, char *error) {
+    udf_context *context = reinterpret_cast<udf_context *>(initid->ptr);
+    response_buffer &result = context->result;
+    result.clear();
+
+    UDF_ARGS request_args = request_arguments(args);
+    if (!validate_request(&request_args, is_null, error)) {
+      return 0;
+    }
+
+    if (args->args[0] == nullptr) {
+      *is_null = 1;
+      return 0;
+    }
+
+    const char *url = request_args.args[1];
+    const char *body = request_args.arg_count > 2 ? request_args.args[2] : nullptr;
+    size_t body_length = body != nullptr ? request_args.lengths[2] : 0;
+
+    long http_status_code = -1;
+    bool transfer_failed = false;
+
+    try {
+      // a json array gives multiple paths
+      std::string paths_argument(args->args[0], args->lengths[0]);
+      bool multiple = paths_argument.find_first_not_of(" \t\r\n") != std::string::npos && paths_argument[paths_argument.find_first_not_of(" \t\r\n")] == '[';
+      std::vector<std::vector<json_path_step>> paths;
+      if (multiple) {
+        for (auto &item : json::parse(paths_argument)) {
+          paths.emplace_back();
+          parse_json_path(item.get<std::string>(), paths.back());
+        }
+      }
+      else {
+        paths.emplace_back();
+        parse_json_path(paths_argument, paths.back());
+      }
+
+      request_template tmpl;
+      compile_request(context, &request_args, tmpl);
+
+      std::string encoded;
+      if (encode_body(tmpl, body, body_length, encoded)) {
+        body = encoded.data();
+        body_length = encoded.size();
+      }
+
+      host_permit permit;
+      std::string limit_message;
+      if (!permit.acquire(url, limit_message)) {
+        throw std::runtime_error(limit_message);
+      }
+
+      pooled_curl_handle handle;
+      CURL *curl = handle.get();
+      if (!curl) {
+        throw std::runtime_error("curl init failed");
+      }
+
+      // the body is not kept, so max response size does not apply
+      json_extractor extractor(std::move(paths));
+      request_body upload(body, body_length);
+      setup_request(curl, tmpl, url, upload, false);
+      curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, json_extract_callback);
+      curl_easy_setopt(curl, CURLOPT_WRITEDATA, &extractor);
+
+      // send the request
+      CURLcode res = perform_transfer(curl);
+
+      // a transfer stopped after all paths are resolved is not an error
+      if (res == CURLE_WRITE_ERROR && extractor.done() && extractor.is_valid()) {
+        json_extract_stopped++;
+        res = CURLE_OK;
+      }
+
+      curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_status_code);
+      record_transfer(curl, res, http_status_code, tmpl.method, url);
+      permit.finish(curl, res, http_status_code);
+
+      if (res != CURLE_OK && extractor.is_valid()) {
+        std::string msg = tmpl.method + " " + std::string(url) + " failed with error code " + std::to_string(http_status_code) + ": " + transfer_error(res);
+        transfer_failed = true;
+        throw std::runtime_error(msg);
+      }
+
+      if (res == CURLE_OK) {
+        extractor.finish();
+      }
+      if (!extractor.is_valid()) {
+        throw std::runtime_error(tmpl.method + " " + std::string(url) + " returned an invalid json response with status " + std::to_string(http_status_code));
+      }
+
+      std::string value;
+      if (!multiple) {
+        if (!extractor.get(0, value)) {
+          *is_null = 1;
+          return 0;
+        }
+      }
+      else {
+        // paths which are not found are null
+        value.push_back('[');
+        std::string item;
+        for (size_t i = 0; i < extractor.size(); i++) {
+          value += i > 0 ? "," : "";
+          value += extractor.get(i, item) ? item : "null";
+        }
+        value.push_back(']');
+      }
+
+      if (!result.assign(value.data(), value.size())) {
+        throw std::runtime_error("out of memory");
+      }
+      *length = result.size;
+    }
+    catch (const std::exception& ex) {
+      result.clear();
+
+      if (!transfer_failed) {
+        log_error(ex.what());
+      }
+      mysql_error_service_printf(ER_GET_ERRMSG, 0, http_status_code, ex.what(), "curl request");
+      *error = 1;
+      *is_null = 1;
+      return 0;
+    }
+
+    return result.data;
+  }
+
+  // define one request of http_request_multi
+  struct multi_transfer {
+    request_template tmpl;
+    std::string url;
+    std::string body;
+    bool has_body = false;
+    request_body upload;
+
+    CURL *curl = nullptr;
+    std::string response;
+    std::string error;
+    long http_status_code = 0;
+    json timings;
+  };
+
+  // read a string member of a request object, null members are treated as missing
+  bool get_string_member(const json &item, const char *name, std::string &value) {
+    auto it = item.find(name);
+    if (it == item.end() || it->is_null()) {
+      return false;
+    }
+    value = it->get<std::string>();
+    return true;
+  }
+
+  // milliseconds of a curl timing given in microseconds
+  double get_timing_ms(CURL *curl, CURLINFO info) {
+    curl_off_t value = 0;
+    curl_easy_getinfo(curl, info, &value);
+    return value / 1000.0;
+  }
+
+  // execute a json array of requests concurrently and return a json array of results in same order
+  const char *httpclient_request_multi_udf(UDF_INIT *initid, UDF_ARGS *args, char *, unsigned long *length, char *is_null, char *error) {
+    udf_context *context = reinterpret_cast<udf_context *>(initid->ptr);
+    context->result.clear();
+
+    MYSQL_THD thd;
+    mysql_service_mysql_current_thread_reader->get(&thd);
+
+    if (!has_privilege(thd)) {
+      mysql_error_service_printf(ER_SPECIFIC_ACCESS_DENIED_ERROR, 0, HTTPCLIENT_PRIVILEGE_NAME);
+      *error = 1;
+      *is_null = 1;
+      return 0;
+    }
+
+    if (args->args[0] == nullptr) {
+      *is_null = 1;
+      return 0;
+    }
+
+    std::vector<multi_transfer> transfers;
+    CURLM *multi = nullptr;
+
+    try {
+      json requests = json::parse(args->args[0], args->args[0] + args->lengths[0]);
+      if (!requests.is_array()) {
+        throw std::runtime_error("requests must be a json array");
+      }
+
+      // compile all requests before sending any of them
+      transfers.resize(requests.size());
+      for (size_t i = 0; i < requests.size(); i++) {
+        auto &item = requests[i];
+        auto &transfer = transfers[i];
+
+        if (!item.is_object() || !get_string_member(item, "url", transfer.url)) {
+          throw std::runtime_error("request " + std::to_string(i) + " must be a json object with an url");
+        }
+
+        std::string method;
+        compile_method(get_string_member(item, "method", method) ? method.c_str() : nullptr, transfer.tmpl);
+        transfer.has_body = get_string_member(item, "body", transfer.body);
+
+        auto headers = item.find("headers");
+        if (headers != item.end() && headers->is_object()) {
+          compile_headers(*headers, transfer.tmpl);
+        }
+
+        auto options = item.find("options");
+        if (options != item.end() && options->is_object()) {
+          compile_curl_options(*options, transfer.tmpl);
+        }
+
+        std::string encoded;
+        if (transfer.has_body && encode_body(transfer.tmpl, transfer.body.data(), transfer.body.size(), encoded)) {
+          transfer.body.swap(encoded);
+        }
+      }
+
+      multi = curl_multi_init();
+      if (multi == nullptr) {
+        throw std::runtime_error("curl multi init failed");
+      }
+      curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, (long)multi_max_host_connections);
+
+      size_t next = 0;
+      size_t running = 0;
+
+      while (next < transfers.size() || running > 0) {
+        // keep at most max in flight transfers running
+        while (next < transfers.size() && running < multi_max_in_flight) {
+          auto &transfer = transfers[next++];
+
+          transfer.curl = my_curl_handle_pool->acquire();
+          if (transfer.curl == nullptr) {
+            transfer.error = "curl init failed";
+            continue;
+          }
+
+          transfer.upload = request_body(transfer.has_body ? transfer.body.data() : nullptr, transfer.body.size());
+          setup_request(transfer.curl, transfer.tmpl, transfer.url.c_str(), transfer.upload);
+          curl_easy_setopt(transfer.curl, CURLOPT_WRITEFUNCTION, write_callback);
+          curl_easy_setopt(transfer.curl, CURLOPT_WRITEDATA, &transfer.response);
+          curl_easy_setopt(transfer.curl, CURLOPT_PRIVATE, &transfer);
+
+          if (curl_multi_add_handle(multi, transfer.curl) != CURLM_OK) {
+            transfer.error = "curl multi add failed";
+            my_curl_handle_pool->release(transfer.curl);
+            transfer.curl = nullptr;
+            continue;
+          }
+
+          running++;
+        }
+
+        int still_running = 0;
+        curl_multi_perform(multi, &still_running);
+
+        CURLMsg *msg;
+        int msgs_left = 0;
+        while ((msg = curl_multi_info_read(multi, &msgs_left)) != nullptr) {
+          if (msg->msg != CURLMSG_DONE) {
+            continue;
+          }
+
+          multi_transfer *transfer = nullptr;
+          CURL *curl = msg->easy_handle;
+          CURLcode res = msg->data.result;
+          curl_easy_getinfo(curl, CURLINFO_PRIVATE, reinterpret_cast<char **>(&transfer));
+          curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &transfer->http_status_code);
+
+          if (res != CURLE_OK) {
+            transfer->error = transfer_error(res);
+          }
+
+          transfer->timings = {
+            {"namelookup_ms", get_timing_ms(curl, CURLINFO_NAMELOOKUP_TIME_T)},
+            {"connect_ms", get_timing_ms(curl, CURLINFO_CONNECT_TIME_T)},
+            {"appconnect_ms", get_timing_ms(curl, CURLINFO_APPCONNECT_TIME_T)},
+            {"starttransfer_ms", get_timing_ms(curl, CURLINFO_STARTTRANSFER_TIME_T)},
+            {"total_ms", get_timing_ms(curl, CURLINFO_TOTAL_TIME_T)}
+          };
+
+          record_transfer(curl, res, transfer->http_status_code, transfer->tmpl.method, transfer->url.c_str());
+
+          curl_multi_remove_handle(multi, curl);
+          my_curl_handle_pool->release(curl);
+          transfer->curl = nullptr;
+          running--;
+        }
+
+        if (running > 0) {
+          curl_multi_poll(multi, nullptr, 0, 1000, nullptr);
+        }
+      }
+
+      curl_multi_cleanup(multi);
+      multi = nullptr;
+
+      json results = json::array();
+      for (auto &transfer : transfers) {
+        results.push_back({
+          {"status", transfer.http_status_code},
+          {"body", transfer.error.empty() ? json(std::move(transfer.response)) : json(nullptr)},
+          {"error", transfer.error.empty() ? json(nullptr) : json(transfer.error)},
+          {"timings", transfer.timings.is_null() ? json::object() : std::move(transfer.timings)}
+        });
+      }
+
+      // invalid utf-8 in response bodies is replaced instead of failing whole result
+      std::string response = results.dump(-1, ' ', false, json::error_handler_t::replace);
+      if (!context->result.assign(response.data(), response.size())) {
+        throw std::runtime_error("out of memory");
+      }
+      *length = response.size();
+    }
+    catch (const std::exception& ex) {
+      // release handles of transfers still running
+      for (auto &transfer : transfers) {
+        if (transfer.curl != nullptr) {
+          curl_multi_remove_handle(multi, transfer.curl);
+          my_curl_handle_pool->release(transfer.curl);
+        }
+      }
+      if (multi != nullptr) {
+        curl_multi_cleanup(multi);
+      }
+
+      log_error(ex.what());
+      mysql_error_service_printf(ER_GET_ERRMSG, 0, -1, ex.what(), "curl request");
+      *error = 1;
+      *is_null = 1;
+      return 0;
+    }
+
+    return context->result.data;
+  }
+
+  // define state of http_request_batch kept for a group of rows
+  struct batch_context {
+    udf_context request;
+    bool denied = false;
+
+    // rows of the current chunk, allocated once and reused between groups
+    std::string buffer;
+    request_template tmpl;
+    std::string url;
+    ulong format = BATCH_FORMAT_NDJSON;
+    unsigned long long chunk_rows = 0;
+
+    // totals of the current group
+    unsigned long long rows = 0;
+    unsigned long long bytes = 0;
+    unsigned long long requests = 0;
+    long last_status = 0;
+    std::string error;
+  };
+
+  // send rows collected in buffer as a single request
+  bool flush_batch(batch_context *batch) {
+    if (batch->chunk_rows == 0) {
+      return true;
+    }
+
+    if (batch->format == BATCH_FORMAT_JSON_ARRAY) {
+      batch->buffer.push_back(']');
+    }
+
+    long http_status_code = -1;
+    CURLcode res = CURLE_FAILED_INIT;
+    request_template tmpl = batch->tmpl;
+
+    std::string encoded;
+    bool is_encoded = encode_body(tmpl, batch->buffer.data(), batch->buffer.size(), encoded);
+    const std::string &body = is_encoded ? encoded : batch->buffer;
+
+    host_permit permit;
+    std::string limit_message;
+    if (!permit.acquire(batch->url.c_str(), limit_message)) {
+      batch->error = limit_message;
+      return false;
+    }
+
+    pooled_curl_handle handle;
+    CURL *curl = handle.get();
+    if (curl != nullptr) {
+      request_body upload(body.data(), body.size());
+      setup_request(curl, tmpl, batch->url.c_str(), upload);
+      curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, discard_callback);
+
+      res = perform_transfer(curl);
+
+      curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_status_code);
+      record_transfer(curl, res, http_status_code, tmpl.method, batch->url.c_str());
+      permit.finish(curl, res, http_status_code);
+    }
+
+    batch->requests++;
+    batch->bytes += batch->buffer.size();
+    batch->last_status = http_status_code;
+    batch->buffer.clear();
+    batch->chunk_rows = 0;
+
+    if (res != CURLE_OK) {
+      batch->error = tmpl.method + " " + batch->url + " failed with error code " + std::to_string(http_status_code) + ": " + transfer_error(res);
+      return false;
+    }
+
+    return true;
+  }
+
+  // initialize aggregate function sending rows of a group in bulk requests
+  static bool httpclient_batch_udf_init(UDF_INIT *initid, UDF_ARGS *args, char *message) {
+    if (args->arg_count < 3) {
+      snprintf(message, MYSQL_ERRMSG_SIZE, "expected METHOD, URL and ROW arguments");
+      return true;
+    }
+
+    const char* name = "utf8mb4";
+    char *value = const_cast<char*>(name);
+    if (mysql_service_mysql_udf_metadata->result_set(initid, "charset", const_cast<char *>(value))) {
+      LogComponentErr(ERROR_LEVEL, ER_LOG_PRINTF_MSG, "failed to set result charset");
+    }
+
+    batch_context *batch = new batch_context();
+    if (compile_constant_arguments(&batch->request, args, message)) {
+      delete batch;
+      return true;
+    }
+
+    batch->buffer.reserve(batch_max_bytes > 0 && batch_max_bytes < 16 * 1024 * 1024 ? batch_max_bytes + 4096 : 16 * 1024 * 1024);
+    initid->ptr = reinterpret_cast<char *>(batch);
+    return 0;
+  }
+
+  // de-initialize aggregate function
+  static void httpclient_batch_udf_deinit(UDF_INIT *initid) {
+    delete reinterpret_cast<batch_context *>(initid->ptr);
+    initid->ptr = nullptr;
+  }
+
+  // reset state at the beginning of each group
+  void httpclient_batch_udf_clear(UDF_INIT *initid, unsigned char *, unsigned char *) {
+    batch_context *batch = reinterpret_cast<batch_context *>(initid->ptr);
+
+    MYSQL_THD thd;
+    mysql_service_mysql_current_thread_reader->get(&thd);
+    batch->denied = !has_privilege(thd);
+
+    batch->buffer.clear();
+    batch->chunk_rows = 0;
+    batch->rows = 0;
+    batch->bytes = 0;
+    batch->requests = 0;
+    batch->last_status = 0;
+    batch->error.clear();
+  }
+
+  // append a row to current chunk and send the chunk once it is full
+  void httpclient_batch_udf_add(UDF_INIT *initid, UDF_ARGS *args, unsigned char *, unsigned char *) {
+    batch_context *batch = reinterpret_cast<batch_context *>(initid->ptr);
+    if (batch->denied || !batch->error.empty() || args->args[2] == nullptr) {
+      return;
+    }
+
+    if (args->args[1] == nullptr) {
+      batch->error = "url must not be null";
+      return;
+    }
+
+    // first row of a chunk decides its url, headers and options
+    if (batch->chunk_rows == 0) {
+      try {
+        compile_request(&batch->request, args, batch->tmpl);
+      }
+      catch (const std::exception& ex) {
+        batch->error = ex.what();
+        return;
+      }
+
+      batch->url.assign(args->args[1], args->lengths[1]);
+      batch->format = batch_format;
+      if (batch->format == BATCH_FORMAT_JSON_ARRAY) {
+        batch->buffer.push_back('[');
+      }
+    }
+    else if (batch->format == BATCH_FORMAT_JSON_ARRAY) {
+      batch->buffer.push_back(',');
+    }
+
+    batch->buffer.append(args->args[2], args->lengths[2]);
+    if (batch->format == BATCH_FORMAT_NDJSON) {
+      batch->buffer.push_back('\n');
+    }
+
+    batch->chunk_rows++;
+    batch->rows++;
+
+    if ((batch_max_rows > 0 && batch->chunk_rows >= batch_max_rows) || (batch_max_bytes > 0 && batch->buffer.size() >= batch_max_bytes)) {
+      flush_batch(batch);
+    }
+  }
+
+  // send remaining rows of the group and return a summary of sent requests
+  const char *httpclient_batch_udf(UDF_INIT *initid, UDF_ARGS *, char *, unsigned long *length, unsigned char *is_null, unsigned char *error) {
+    batch_context *batch = reinterpret_cast<batch_context *>(initid->ptr);
+    udf_context *context = &batch->request;
+    context->result.clear();
+
+    if (batch->denied) {
+      mysql_error_service_printf(ER_SPECIFIC_ACCESS_DENIED_ERROR, 0, HTTPCLIENT_PRIVILEGE_NAME);
+      *error = 1;
+      *is_null = 1;
+      return 0;
+    }
+
+    if (batch->error.empty()) {
+      flush_batch(batch);
+    }
+
+    if (!batch->error.empty()) {
+      log_error(batch->error.c_str());
+      mysql_error_service_printf(ER_GET_ERRMSG, 0, batch->last_status, batch->error.c_str(), "curl request");
+      *error = 1;
+      *is_null = 1;
+      return 0;
+    }
+
+    json summary = {
+      {"requests", batch->requests},
+      {"rows", batch->rows},
+      {"bytes", batch->bytes},
+      {"status", batch->last_status}
+    };
+
+    std::string response = summary.dump();
+    if (!context->result.assign(response.data(), response.size())) {
+      *error = 1;
+      *is_null = 1;
+      return 0;
+    }
+    *length = response.size();
+    return context->result.data;
+  }
+
+  // copy a request into background dispatcher, returns false if it was not queued
+  bool queue_background_request(udf_context *context, UDF_ARGS *args, unsigned long long async_id, const char *func_name, char *error) {
+    // copy arguments since they are only valid during this call
+    std::unique_ptr<background_request> request(new background_request());
+    try {
+      compile_request(context, args, request->tmpl);
+    }
+    catch (const std::exception& ex) {
+      log_error(ex.what());
+      mysql_error_service_printf(ER_GET_ERRMSG, 0, -1, ex.what(), "curl request");
+      *error = 1;
+      return false;
+    }
 
-      // successful if list of functions is empty
-      if (set.empty()) {
-        return true;
+    request->url.assign(args->args[1], args->lengths[1]);
+    if (args->arg_count > 2 && args->args[2] != nullptr) {
+      // compress in caller thread, so dispatcher threads only send
+      if (!encode_body(request->tmpl, args->args[2], args->lengths[2], request->body)) {
+        request->body.assign(args->args[2], args->lengths[2]);
       }
+      request->has_body = true;
+    }
+    request->async_id = async_id;
 
-      return false;
+    if (my_background_dispatcher->submit(request.get(), nowait_overflow_policy == NOWAIT_OVERFLOW_BLOCK)) {
+      request.release();
+      return true;
     }
 
-};
-udf_manager *my_udf_manager;
+    nowait_dropped++;
+    if (nowait_overflow_policy == NOWAIT_OVERFLOW_ERROR) {
+      mysql_error_service_printf(ER_UDF_ERROR, 0, func_name, "background request queue is full");
+      *error = 1;
+    }
 
-namespace udf_impl {
-  const char *udf_init = "udf_init", *my_udf = "my_udf";
+    return false;
+  }
 
-  thread_local bool nowait = false;
+  // queue curl request to background dispatcher and return without waiting for response
+  const char *httpclient_request_nowait_udf(UDF_INIT *initid, UDF_ARGS *args, char *, unsigned long *, char *is_null, char *error) {
+    udf_context *context = reinterpret_cast<udf_context *>(initid->ptr);
+    *is_null = 1;
 
-  // initialize any given function
-  static bool httpclient_udf_init(UDF_INIT *initid, UDF_ARGS *, char *) {
-    const char* name = "utf8mb4";
-    char *value = const_cast<char*>(name);
-    initid->ptr = const_cast<char *>(udf_init);
-    if (mysql_service_mysql_udf_metadata->result_set(initid, "charset", const_cast<char *>(value))) {
-      LogComponentErr(ERROR_LEVEL, ER_LOG_PRINTF_MSG, "failed to set result charset");
-      return false;
+    if (validate_request(args, is_null, error)) {
+      queue_background_request(context, args, 0, "http_request_nowait", error);
     }
+
     return 0;
   }
 
-  // initialize any given function
-  static void httpclient_udf_deinit(__attribute__((unused)) UDF_INIT *initid) {
-    assert(initid->ptr == udf_impl::udf_init || initid->ptr == udf_impl::my_udf);
-  }
+  // queue curl request to background dispatcher and return an id to collect its response later
+  long long httpclient_request_async_udf(UDF_INIT *initid, UDF_ARGS *args, char *is_null, char *error) {
+    udf_context *context = reinterpret_cast<udf_context *>(initid->ptr);
 
-  // check if privilege is granted for current user
-  bool has_privilege(void *opaque_thd) {
-    // get the security context of the thread
-    Security_context_handle ctx = nullptr;
-    if (mysql_service_mysql_thd_security_context->get(opaque_thd, &ctx) || !ctx) {
-      LogComponentErr(ERROR_LEVEL, ER_LOG_PRINTF_MSG, "problem trying to get security context");
-      return false;
+    if (!validate_request(args, is_null, error)) {
+      return 0;
     }
 
-    if (mysql_service_global_grants_check->has_global_grant(ctx, HTTPCLIENT_PRIVILEGE_NAME, strlen(HTTPCLIENT_PRIVILEGE_NAME))) {
-      return true;
+    auto id = my_async_response_store->create();
+    if (!queue_background_request(context, args, id, "http_request_async", error)) {
+      my_async_response_store->remove(id);
+      *is_null = 1;
+      return 0;
     }
 
-    return false;
-  }
-
-  // curl write function
-  size_t write_callback(void *contents, size_t size, size_t nmemb, void *userp) {
-    size_t total_size = size * nmemb;
-    std::string *response = static_cast<std::string *>(userp);
-    response->append(static_cast<const char *>(contents), total_size);
-    return total_size;
+    return (long long)id;
   }
 
-  // perform curl request with given options
-  const char *httpclient_request_udf(UDF_INIT *initid, UDF_ARGS *args, char *outp, unsigned long *length, char *is_null, char *error) {
+  // check privilege and request id argument of response functions
+  bool validate_response_request(UDF_ARGS *args, char *is_null, char *error) {
     MYSQL_THD thd;
     mysql_service_mysql_current_thread_reader->get(&thd);
 
@@ -305,163 +5169,332 @@ namespace udf_impl {
       mysql_error_service_printf(ER_SPECIFIC_ACCESS_DENIED_ERROR, 0, HTTPCLIENT_PRIVILEGE_NAME);
       *error = 1;
       *is_null = 1;
+      return false;
+    }
+
+    if (args->args[0] == nullptr) {
+      *is_null = 1;
+      return false;
+    }
+
+    return true;
+  }
+
+  // return body of an async response, null while it is pending or after it expired
+  const char *httpclient_response_udf(UDF_INIT *initid, UDF_ARGS *args, char *, unsigned long *length, char *is_null, char *error) {
+    udf_context *context = reinterpret_cast<udf_context *>(initid->ptr);
+    context->result.clear();
+
+    if (!validate_response_request(args, is_null, error)) {
       return 0;
     }
 
-    auto arg_count = args->arg_count;
-    if (arg_count < 2) {
-      mysql_error_service_printf(ER_AUDIT_LOG_UDF_INVALID_ARGUMENT_COUNT, 0);
+    long status;
+    std::string body;
+    auto id = *reinterpret_cast<long long *>(args->args[0]);
+    if (id <= 0 || !my_async_response_store->get((unsigned long long)id, &status, &body) || status == 0) {
+      *is_null = 1;
+      return 0;
+    }
+
+    if (!context->result.assign(body.data(), body.size())) {
       *error = 1;
       *is_null = 1;
       return 0;
     }
+    *length = body.size();
+    return context->result.data;
+  }
 
-    const char *method = args->args[0];
-    const char *url = args->args[1];
-    const char *body = arg_count > 2 ? args->args[2] : nullptr;
-    const char *headers = arg_count > 3 ? args->args[3] : nullptr;
-    const char *curl_options = arg_count > 4 ? args->args[4] : nullptr;
-    const bool fire_and_forget = nowait;
-    nowait = false;
+  // return http status code of an async response, 0 if the transfer failed and null while it is pending
+  long long httpclient_response_status_udf(UDF_INIT *, UDF_ARGS *args, char *is_null, char *error) {
+    if (!validate_response_request(args, is_null, error)) {
+      return 0;
+    }
 
-    CURL *curl;
-    long http_status_code = -1;
+    long status;
+    auto id = *reinterpret_cast<long long *>(args->args[0]);
+    if (id <= 0 || !my_async_response_store->get((unsigned long long)id, &status, nullptr)) {
+      *is_null = 1;
+      return 0;
+    }
 
-    try {
-      curl = curl_easy_init();
-      if (!curl) {
-        throw "curl init failed";
-      }
+    return status;
+  }
+}
 
-      if (fire_and_forget) {
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, 1);
-      }
+// show number of requests waiting in background queue
+static int show_nowait_queue_depth(MYSQL_THD, SHOW_VAR *var, char *buf) {
+  var->type = SHOW_LONGLONG;
+  var->value = buf;
+  *reinterpret_cast<unsigned long long *>(buf) = udf_impl::my_background_dispatcher != nullptr ? udf_impl::my_background_dispatcher->queue_depth() : 0;
+  return 0;
+}
 
-      // set all given curl options
-      if (curl_options != nullptr && strcmp(curl_options, "") != 0) {
-        json curl_options_json = json::parse(curl_options);
+// define cursor of a scan of performance_schema.httpclient_requests
+struct request_history_table {
+  unsigned long long position = 0;
+  unsigned long long next_position = 0;
+  unsigned long long end_position = 0;
+  request_record record;
+};
 
-        for (auto& item : curl_options_json.items())
-        {
-          std::string opt_name = item.key();
+static PSI_table_handle *request_history_open_table(PSI_pos **pos) {
+  auto table = new request_history_table();
+  *pos = reinterpret_cast<PSI_pos *>(&table->position);
+  return reinterpret_cast<PSI_table_handle *>(table);
+}
 
-          auto it = curl_options_available.find(opt_name);
-          if (it == curl_options_available.end()) {
-            continue;
-          }
+static void request_history_close_table(PSI_table_handle *handle) {
+  delete reinterpret_cast<request_history_table *>(handle);
+}
 
-          CURLoption opt_constant = std::get<0>(curl_options_available[opt_name]);
-          long opt_type = std::get<1>(curl_options_available[opt_name]);
-          auto opt_type_str = std::to_string(opt_type);
+// scan records present when the scan started, records older than ttl are hidden
+static int request_history_rnd_init(PSI_table_handle *handle, bool) {
+  auto table = reinterpret_cast<request_history_table *>(handle);
+  table->next_position = my_request_history->begin();
+  table->end_position = my_request_history->end();
+  return 0;
+}
 
-          if (opt_type == CURLOPTTYPE_LONG) {
-            auto value = item.value().get<long>();
-            auto value_str = std::to_string(value);
-            curl_easy_setopt(curl, opt_constant, value);
-          }
-          else if (opt_type == CURLOPTTYPE_STRINGPOINT) {
-            auto value = item.value().get<std::string>();
-            curl_easy_setopt(curl, opt_constant, value);
-          }
-        }
-      }
+static bool request_history_visible(const request_record &record) {
+  if (request_history_ttl == 0) {
+    return true;
+  }
+
+  auto now_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  return record.timestamp_us + request_history_ttl * 1000000ULL >= (unsigned long long)now_us;
+}
 
-      // set all given headers
-      if (headers != nullptr && strcmp(headers, "") != 0) {
-        struct curl_slist* header_list = NULL;
-        json headers_json = json::parse(headers);
+static int request_history_rnd_next(PSI_table_handle *handle) {
+  auto table = reinterpret_cast<request_history_table *>(handle);
 
-        for (auto& item : headers_json.items())
-        {
-          auto key = item.key();
-          auto value = item.value().get<std::string>();
-          auto header = key + ": " + value;
-          auto header_chr = header.c_str();
-          header_list = curl_slist_append(header_list, header_chr);
-        }
-        
-        if (header_list != nullptr) {
-          curl_easy_setopt(curl, CURLOPT_HTTPHEADER, header_list);
-        }
-      }
+  // skip records overwritten since the scan started
+  auto begin_position = my_request_history->begin();
+  if (table->next_position < begin_position) {
+    table->next_position = begin_position;
+  }
 
-      // set request method and url
-      curl_easy_setopt(curl, CURLOPT_URL, url);
+  for (; table->next_position < table->end_position; table->next_position++) {
+    if (my_request_history->read(table->next_position, table->record) && request_history_visible(table->record)) {
+      table->position = table->next_position++;
+      return 0;
+    }
+  }
 
-      std::string method_upper = method;
-      std::transform(method_upper.begin(), method_upper.end(), method_upper.begin(), ::toupper);
+  return PFS_HA_ERR_END_OF_FILE;
+}
 
-      if (method_upper == "POST") {
-        curl_easy_setopt(curl, CURLOPT_POST, 1);
-      }
-      else if (method_upper == "PUT" || method_upper == "PATCH" || method_upper == "DELETE") {
-        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, method_upper);
-      }
-      else {
-        curl_easy_setopt(curl, CURLOPT_HTTPGET, 1);
-        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "GET");
-      }
+static int request_history_rnd_pos(PSI_table_handle *handle) {
+  auto table = reinterpret_cast<request_history_table *>(handle);
+  if (!my_request_history->read(table->position, table->record)) {
+    return PFS_HA_ERR_RECORD_DELETED;
+  }
+  return 0;
+}
 
-      if (body != nullptr) {
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body);
-      }
+static void request_history_reset_position(PSI_table_handle *handle) {
+  auto table = reinterpret_cast<request_history_table *>(handle);
+  table->position = 0;
+  table->next_position = 0;
+}
 
-      // set the callback function for writing the response data
-      std::string response;
-      curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-      curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-      
-      // send the request
-      auto start_time = std::chrono::steady_clock::now();
-      CURLcode res = curl_easy_perform(curl);
-      auto end_time = std::chrono::steady_clock::now();
+static void set_bigint_column(PSI_field *field, unsigned long long value, bool is_null = false) {
+  mysql_service_pfs_plugin_column_bigint_v1->set_unsigned(field, {value, is_null});
+}
 
-      curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_status_code);
-      
-      curl_easy_cleanup(curl);
+static int request_history_read_column_value(PSI_table_handle *handle, PSI_field *field, unsigned int index) {
+  auto &record = reinterpret_cast<request_history_table *>(handle)->record;
 
-      // log to mysql error log
-      if (res != CURLE_OK) {
-        auto http_error_message = curl_easy_strerror(res);
-        std::string msg = std::string(method) + " " + std::string(url) + " failed with error code " + std::to_string(http_status_code) + ": " + std::string(http_error_message);
-        throw std::runtime_error(msg);
-      }
-      
-      std::string msg = std::string(method) + " " + std::string(url) + " returned status code " + std::to_string(http_status_code);
-      LogComponentErr(INFORMATION_LEVEL, ER_LOG_PRINTF_MSG, msg.c_str());
+  switch (index) {
+    case 0:
+      mysql_service_pfs_plugin_column_timestamp_v2->set2(field, record.timestamp_us);
+      break;
+    case 1:
+      set_bigint_column(field, record.thread_id, record.thread_id == 0);
+      break;
+    case 2:
+      mysql_service_pfs_plugin_column_string_v2->set_varchar_utf8mb4_len(field, record.method, record.method_length);
+      break;
+    case 3:
+      mysql_service_pfs_plugin_column_string_v2->set_varchar_utf8mb4_len(field, record.host, record.host_length);
+      break;
+    case 4:
+      mysql_service_pfs_plugin_column_integer_v1->set(field, {(int)record.status, record.status <= 0});
+      break;
+    case 5:
+      mysql_service_pfs_plugin_column_integer_v1->set(field, {record.curl_code, false});
+      break;
+    case 6:
+      set_bigint_column(field, record.bytes_sent);
+      break;
+    case 7:
+      set_bigint_column(field, record.bytes_received);
+      break;
+    case 8:
+      set_bigint_column(field, record.dns_us);
+      break;
+    case 9:
+      set_bigint_column(field, record.connect_us);
+      break;
+    case 10:
+      set_bigint_column(field, record.tls_us);
+      break;
+    case 11:
+      set_bigint_column(field, record.ttfb_us);
+      break;
+    case 12:
+      set_bigint_column(field, record.total_us);
+      break;
+    case 13:
+      mysql_service_pfs_plugin_column_enum_v1->set(field, {record.cache_hit ? 1ULL : 2ULL, false});
+      break;
+    case 14:
+      mysql_service_pfs_plugin_column_enum_v1->set(field, {record.connection_reused ? 1ULL : 2ULL, false});
+      break;
+    default:
+      break;
+  }
 
-      auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
-      time_spent_ms += elapsed_time;
-      number_of_requests++;
+  return 0;
+}
 
-      // since message size is possibly bigger than 255, "outp" buffer is not usable (e.g. memcpy(outp, response.c_str()))
-      // we must a dynamically allocated buffer defined in init function
-      initid->ptr = strdup(response.c_str());
-      *length = response.size();
-    }
-    catch (const std::exception& ex) {
-      initid->ptr = NULL;
+static unsigned long long request_history_row_count() {
+  return my_request_history->capacity();
+}
 
-      auto msg = std::string(ex.what());
-      if (fire_and_forget && msg.find("Timeout") != std::string::npos) {
-        // bypass timeout error to allow fire and forget
-      }
-      else {
-        LogComponentErr(ERROR_LEVEL, ER_LOG_PRINTF_MSG, msg.c_str());
-        mysql_error_service_printf(ER_GET_ERRMSG, 0, http_status_code, msg.c_str(), "curl request");
-        *error = 1;
-        *is_null = 1;
-      }
-    }
+static PFS_engine_table_share_proxy request_history_share;
+static PFS_engine_table_share_proxy *request_history_shares[] = {&request_history_share};
 
-    return initid->ptr;
-  }
+// add performance_schema.httpclient_requests table
+static bool register_request_history_table() {
+  auto &share = request_history_share;
+  share.m_table_name = "httpclient_requests";
+  share.m_table_name_length = strlen(share.m_table_name);
+  share.m_table_definition =
+    "TIMESTAMP TIMESTAMP(6) NOT NULL, THREAD_ID BIGINT UNSIGNED, METHOD VARCHAR(16) NOT NULL, HOST VARCHAR(255) NOT NULL, "
+    "STATUS INTEGER, CURL_CODE INTEGER NOT NULL, BYTES_SENT BIGINT UNSIGNED NOT NULL, BYTES_RECEIVED BIGINT UNSIGNED NOT NULL, "
+    "DNS_US BIGINT UNSIGNED NOT NULL, CONNECT_US BIGINT UNSIGNED NOT NULL, TLS_US BIGINT UNSIGNED NOT NULL, "
+    "TTFB_US BIGINT UNSIGNED NOT NULL, TOTAL_US BIGINT UNSIGNED NOT NULL, "
+    "CACHE_HIT ENUM('YES','NO') NOT NULL, CONNECTION_REUSED ENUM('YES','NO') NOT NULL";
+  share.m_ref_length = sizeof(unsigned long long);
+  share.m_acl = READONLY;
+  share.delete_all_rows = nullptr;
+  share.get_row_count = request_history_row_count;
+  share.m_proxy_engine_table = {
+    request_history_rnd_next, request_history_rnd_init, request_history_rnd_pos,
+    nullptr, nullptr, nullptr,
+    request_history_read_column_value, request_history_reset_position,
+    nullptr, nullptr, nullptr, nullptr, nullptr,
+    request_history_open_table, request_history_close_table
+  };
+
+  return mysql_service_pfs_plugin_table_v1->add_tables(request_history_shares, 1) != 0;
+}
+
+static bool unregister_request_history_table() {
+  return mysql_service_pfs_plugin_table_v1->delete_tables(request_history_shares, 1) != 0;
+}
+
+// show hosts whose circuit breaker is open or half open as a list of "host:state"
+static int show_breaker_state(MYSQL_THD, SHOW_VAR *var, char *buf) {
+  var->type = SHOW_CHAR;
+  var->value = buf;
 
-  // perform curl request and do not wait for response
-  const char *httpclient_request_nowait_udf(UDF_INIT *initid, UDF_ARGS *args, char *outp, unsigned long *length, char *is_null, char *error) {
-    nowait = true;
-    return httpclient_request_udf(initid, args, outp, length, is_null, error);
+  std::string value = my_host_registry != nullptr ? my_host_registry->breaker_state() : "";
+  snprintf(buf, SHOW_VAR_FUNC_BUFF_SIZE, "%s", value.c_str());
+  return 0;
+}
+
+// register an unsigned integer system variable
+static bool register_uint_variable(const char *name, int flags, const char *comment, uint *value, uint def_val, uint min_val, uint max_val) {
+  INTEGRAL_CHECK_ARG(uint) arg;
+  arg.def_val = def_val;
+  arg.min_val = min_val;
+  arg.max_val = max_val;
+  arg.blk_sz = 0;
+  return mysql_service_component_sys_variable_register->register_variable("httpclient", name, PLUGIN_VAR_INT | PLUGIN_VAR_UNSIGNED | flags, comment, nullptr, nullptr, (void *)&arg, (void *)value);
+}
+
+// register an unsigned long system variable
+static bool register_ulong_variable(const char *name, int flags, const char *comment, ulong *value, ulong def_val, ulong min_val, ulong max_val) {
+  INTEGRAL_CHECK_ARG(ulong) arg;
+  arg.def_val = def_val;
+  arg.min_val = min_val;
+  arg.max_val = max_val;
+  arg.blk_sz = 0;
+  return mysql_service_component_sys_variable_register->register_variable("httpclient", name, PLUGIN_VAR_LONG | PLUGIN_VAR_UNSIGNED | flags, comment, nullptr, nullptr, (void *)&arg, (void *)value);
+}
+
+// register a boolean system variable
+static bool register_bool_variable(const char *name, int flags, const char *comment, bool *value, bool def_val) {
+  BOOL_CHECK_ARG(bool) arg;
+  arg.def_val = def_val;
+  return mysql_service_component_sys_variable_register->register_variable("httpclient", name, PLUGIN_VAR_BOOL | flags, comment, nullptr, nullptr, (void *)&arg, (void *)value);
+}
+
+// register a read only string system variable
+static bool register_string_variable(const char *name, int flags, const char *comment, char **value) {
+  STR_CHECK_ARG(str) arg;
+  arg.def_val = nullptr;
+  return mysql_service_component_sys_variable_register->register_variable("httpclient", name, PLUGIN_VAR_STR | PLUGIN_VAR_MEMALLOC | PLUGIN_VAR_READONLY | flags, comment, nullptr, nullptr, (void *)&arg, (void *)value);
+}
+
+// register an enum system variable
+static bool register_enum_variable(const char *name, int flags, const char *comment, ulong *value, ulong def_val, TYPELIB *typelib) {
+  ENUM_CHECK_ARG(enum) arg;
+  arg.def_val = def_val;
+  arg.typelib = typelib;
+  return mysql_service_component_sys_variable_register->register_variable("httpclient", name, PLUGIN_VAR_ENUM | flags, comment, nullptr, nullptr, (void *)&arg, (void *)value);
+}
+
+// register all system variables of this component
+static bool register_system_variables() {
+  return register_uint_variable("connection_pool_size", 0, "Maximum number of idle curl handles kept for reuse", &connection_pool_size, 16, 0, 1024) ||
+    register_uint_variable("nowait_queue_size", PLUGIN_VAR_READONLY, "Capacity of the background request queue of http_request_nowait", &nowait_queue_size, 1024, 16, 1048576) ||
+    register_uint_variable("nowait_max_in_flight", 0, "Maximum number of concurrent background requests", &nowait_max_in_flight, 64, 1, 65536) ||
+    register_uint_variable("nowait_timeout_ms", 0, "Default timeout of background requests in milliseconds", &nowait_timeout_ms, 30000, 1, 3600000) ||
+    register_enum_variable("nowait_overflow_policy", 0, "Action when background request queue is full: BLOCK, DROP or ERROR", &nowait_overflow_policy, NOWAIT_OVERFLOW_DROP, &nowait_overflow_policy_typelib) ||
+    register_ulong_variable("async_memory_limit", 0, "Maximum bytes of uncollected http_request_async responses kept in memory", &async_memory_limit, 64 * 1024 * 1024, 0, ULONG_MAX) ||
+    register_uint_variable("async_response_ttl", 0, "Seconds to keep a completed http_request_async response", &async_response_ttl, 600, 1, 31536000) ||
+    register_uint_variable("multi_max_in_flight", 0, "Maximum number of concurrent requests of a http_request_multi call", &multi_max_in_flight, 16, 1, 1024) ||
+    register_uint_variable("multi_max_host_connections", 0, "Maximum number of connections per host of a http_request_multi call, 0 is unlimited", &multi_max_host_connections, 0, 0, 1024) ||
+    register_uint_variable("batch_max_rows", 0, "Maximum number of rows sent in a single http_request_batch request, 0 is unlimited", &batch_max_rows, 1000, 0, UINT_MAX) ||
+    register_ulong_variable("batch_max_bytes", 0, "Maximum body size of a single http_request_batch request, 0 is unlimited", &batch_max_bytes, 4 * 1024 * 1024, 0, ULONG_MAX) ||
+    register_enum_variable("batch_format", 0, "Body format of http_request_batch requests: NDJSON or JSON_ARRAY", &batch_format, BATCH_FORMAT_NDJSON, &batch_format_typelib) ||
+    register_ulong_variable("cache_size", 0, "Maximum bytes of GET responses kept in response cache, 0 disables the cache", &cache_size, 0, 0, ULONG_MAX) ||
+    register_ulong_variable("max_response_size", 0, "Maximum size of a response body, larger transfers are aborted, 0 is unlimited", &max_response_size, 0, 0, ULONG_MAX) ||
+    register_uint_variable("request_history_size", PLUGIN_VAR_READONLY, "Number of recent requests kept in performance_schema.httpclient_requests, 0 disables the history", &request_history_size, 1000, 0, 1048576) ||
+    register_uint_variable("request_history_ttl", 0, "Seconds a request is shown in performance_schema.httpclient_requests, 0 keeps it until overwritten", &request_history_ttl, 3600, 0, 31536000) ||
+    register_enum_variable("log_level", 0, "Requests written to error log: NONE, ERROR (failed), WARNING (also slow and 5xx) or INFORMATION (all)", &log_level, LOG_LEVEL_WARNING, &log_level_typelib) ||
+    register_uint_variable("log_sample_rate", 0, "Log 1 in N successful requests when log_level is INFORMATION", &log_sample_rate, 1, 1, 1000000) ||
+    register_uint_variable("log_slow_ms", 0, "Requests taking at least this many milliseconds are logged as slow, 0 disables", &log_slow_ms, 1000, 0, 3600000) ||
+    register_uint_variable("host_max_in_flight", 0, "Maximum number of concurrent requests to a single host, 0 is unlimited", &host_max_in_flight, 0, 0, 65536) ||
+    register_uint_variable("host_rate_limit", 0, "Maximum number of requests per second to a single host, 0 is unlimited", &host_rate_limit, 0, 0, 1000000) ||
+    register_uint_variable("host_wait_timeout_ms", 0, "Maximum time a request waits for host concurrency or rate limits", &host_wait_timeout_ms, 10000, 0, 3600000) ||
+    register_uint_variable("breaker_failure_threshold", 0, "Consecutive failures of a host opening its circuit breaker, 0 disables circuit breakers", &breaker_failure_threshold, 0, 0, 1000000) ||
+    register_uint_variable("breaker_latency_ms", 0, "Requests slower than this many milliseconds count as failures for circuit breaker, 0 disables", &breaker_latency_ms, 0, 0, 3600000) ||
+    register_uint_variable("breaker_open_ms", 0, "Time an open circuit breaker rejects requests before a probe request is sent", &breaker_open_ms, 30000, 1, 86400000) ||
+    register_bool_variable("accept_encoding", 0, "Ask for compressed responses using any encoding supported by curl and decode them, HTTPCLIENT_DECODE overrides it per call", &accept_encoding, true) ||
+    register_uint_variable("compress_min_size", 0, "Minimum size of a request body compressed by HTTPCLIENT_COMPRESS option", &compress_min_size, 1024, 0, UINT_MAX) ||
+    register_string_variable("preconnect", 0, "Comma separated urls whose origins are connected to in background when the component starts", &preconnect_urls) ||
+    register_uint_variable("preconnect_connections", 0, "Number of connections opened to each origin of httpclient.preconnect", &preconnect_connections, 2, 1, 256) ||
+    register_bool_variable("multiplex", 0, "Send requests of all sessions on a shared transport multiplexing them on http/2 connections", &multiplex, false) ||
+    register_uint_variable("max_concurrent_streams", 0, "Maximum concurrent requests on a single http/2 connection of the shared transport", &max_concurrent_streams, 100, 1, 1000);
+}
+
+// unregister all system variables of this component
+static bool unregister_system_variables() {
+  const char *names[] = {"connection_pool_size", "nowait_queue_size", "nowait_max_in_flight", "nowait_timeout_ms", "nowait_overflow_policy", "async_memory_limit", "async_response_ttl", "multi_max_in_flight", "multi_max_host_connections", "batch_max_rows", "batch_max_bytes", "batch_format", "cache_size", "max_response_size", "request_history_size", "request_history_ttl", "log_level", "log_sample_rate", "log_slow_ms", "host_max_in_flight", "host_rate_limit", "host_wait_timeout_ms", "breaker_failure_threshold", "breaker_latency_ms", "breaker_open_ms", "accept_encoding", "compress_min_size", "preconnect", "preconnect_connections", "multiplex", "max_concurrent_streams"};
+  bool failed = false;
+
+  for (auto name : names) {
+    if (mysql_service_component_sys_variable_unregister->unregister_variable("httpclient", name)) {
+      failed = true;
+    }
   }
+
+  return failed;
 }
 
 // initialize the component
@@ -473,6 +5506,58 @@ static mysql_service_status_t httpclient_service_init() {
 
   LogComponentErr(INFORMATION_LEVEL, ER_LOG_PRINTF_MSG, "started initializing the component");
 
+  // initialize curl once for the whole component, handles are shared between threads
+  if (curl_global_init(CURL_GLOBAL_DEFAULT) != CURLE_OK) {
+    LogComponentErr(ERROR_LEVEL, ER_LOG_PRINTF_MSG, "failed to initialize curl");
+    return 1;
+  }
+
+  my_curl_handle_pool = new curl_handle_pool();
+
+  // register custom system variables
+  if (register_system_variables()) {
+    LogComponentErr(ERROR_LEVEL, ER_LOG_PRINTF_MSG, "failed to register system variable(s)");
+  }
+  else {
+    LogComponentErr(INFORMATION_LEVEL, ER_LOG_PRINTF_MSG, "system variable(s) registered");
+  }
+
+  my_response_cache = new response_cache();
+  my_request_coalescer = new request_coalescer();
+
+  // write request logs from a background thread
+  my_request_logger = new request_logger();
+  my_request_logger->start();
+
+  my_host_registry = new host_registry();
+  udf_impl::my_profile_registry = new udf_impl::profile_registry();
+
+  // keep recent requests for performance_schema.httpclient_requests
+  my_request_history = new request_history(request_history_size);
+  if (register_request_history_table()) {
+    LogComponentErr(ERROR_LEVEL, ER_LOG_PRINTF_MSG, "failed to register performance_schema table");
+  }
+
+  // start background dispatcher of http_request_nowait and http_request_async
+  my_async_response_store = new async_response_store();
+  udf_impl::my_background_dispatcher = new udf_impl::background_dispatcher(nowait_queue_size);
+  if (!udf_impl::my_background_dispatcher->start()) {
+    LogComponentErr(ERROR_LEVEL, ER_LOG_PRINTF_MSG, "failed to start background dispatcher");
+    delete udf_impl::my_background_dispatcher;
+    udf_impl::my_background_dispatcher = nullptr;
+    return 1;
+  }
+
+  // start shared transport of httpclient.multiplex, requests are sent by sessions themselves if it is not running
+  udf_impl::my_transport_dispatcher = new udf_impl::transport_dispatcher();
+  if (!udf_impl::my_transport_dispatcher->start()) {
+    LogComponentErr(WARNING_LEVEL, ER_LOG_PRINTF_MSG, "failed to start shared transport, requests will not be multiplexed");
+  }
+
+  // open keep-alive connections to configured origins without delaying the installation
+  udf_impl::my_startup_preconnector = new udf_impl::startup_preconnector();
+  udf_impl::my_startup_preconnector->start(preconnect_urls);
+
   // register custom status variables
   if (mysql_service_status_variable_registration->register_variable((SHOW_VAR *)&httpclient_status_variables)) {
     LogComponentErr(ERROR_LEVEL, ER_LOG_PRINTF_MSG, "failed to register status variable(s)");
@@ -498,12 +5583,90 @@ static mysql_service_status_t httpclient_service_init() {
     return 1;
   }
 
+  if (!my_udf_manager->register_function("http_request_profile", Item_result::STRING_RESULT, (Udf_func_any)udf_impl::httpclient_request_profile_udf, udf_impl::httpclient_request_profile_udf_init, udf_impl::httpclient_udf_deinit)) {
+    // failed to register udf
+    delete my_udf_manager;
+    return 1;
+  }
+
+  if (!my_udf_manager->register_function("http_profile_set", Item_result::INT_RESULT, (Udf_func_any)udf_impl::httpclient_profile_set_udf, udf_impl::httpclient_profile_set_udf_init, nullptr)) {
+    // failed to register udf
+    delete my_udf_manager;
+    return 1;
+  }
+
+  if (!my_udf_manager->register_function("http_profile_drop", Item_result::INT_RESULT, (Udf_func_any)udf_impl::httpclient_profile_drop_udf, udf_impl::httpclient_profile_drop_udf_init, nullptr)) {
+    // failed to register udf
+    delete my_udf_manager;
+    return 1;
+  }
+
+  if (!my_udf_manager->register_function("http_preconnect", Item_result::INT_RESULT, (Udf_func_any)udf_impl::httpclient_preconnect_udf, udf_impl::httpclient_preconnect_udf_init, nullptr)) {
+    // failed to register udf
+    delete my_udf_manager;
+    return 1;
+  }
+
   if (!my_udf_manager->register_function("http_request_nowait", Item_result::STRING_RESULT, (Udf_func_any)udf_impl::httpclient_request_nowait_udf, udf_impl::httpclient_udf_init, udf_impl::httpclient_udf_deinit)) {
     // failed to register udf
     delete my_udf_manager;
     return 1;
   }
 
+  if (!my_udf_manager->register_function("http_request_to_file", Item_result::STRING_RESULT, (Udf_func_any)udf_impl::httpclient_request_to_file_udf, udf_impl::httpclient_to_file_udf_init, udf_impl::httpclient_udf_deinit)) {
+    // failed to register udf
+    delete my_udf_manager;
+    return 1;
+  }
+
+  if (!my_udf_manager->register_function("http_json_extract", Item_result::STRING_RESULT, (Udf_func_any)udf_impl::httpclient_json_extract_udf, udf_impl::httpclient_json_extract_udf_init, udf_impl::httpclient_udf_deinit)) {
+    // failed to register udf
+    delete my_udf_manager;
+    return 1;
+  }
+
+  if (!my_udf_manager->register_function("http_request_multi", Item_result::STRING_RESULT, (Udf_func_any)udf_impl::httpclient_request_multi_udf, udf_impl::httpclient_multi_udf_init, udf_impl::httpclient_udf_deinit)) {
+    // failed to register udf
+    delete my_udf_manager;
+    return 1;
+  }
+
+  if (!my_udf_manager->register_aggregate_function("http_request_batch", Item_result::STRING_RESULT, (Udf_func_any)udf_impl::httpclient_batch_udf, udf_impl::httpclient_batch_udf_init, udf_impl::httpclient_batch_udf_deinit, udf_impl::httpclient_batch_udf_add, udf_impl::httpclient_batch_udf_clear)) {
+    // failed to register udf
+    delete my_udf_manager;
+    return 1;
+  }
+
+  if (!my_udf_manager->register_function("http_cache_invalidate", Item_result::INT_RESULT, (Udf_func_any)udf_impl::httpclient_cache_invalidate_udf, udf_impl::httpclient_cache_invalidate_udf_init, nullptr)) {
+    // failed to register udf
+    delete my_udf_manager;
+    return 1;
+  }
+
+  if (!my_udf_manager->register_function("http_host_limit", Item_result::INT_RESULT, (Udf_func_any)udf_impl::httpclient_host_limit_udf, udf_impl::httpclient_host_limit_udf_init, nullptr)) {
+    // failed to register udf
+    delete my_udf_manager;
+    return 1;
+  }
+
+  if (!my_udf_manager->register_function("http_request_async", Item_result::INT_RESULT, (Udf_func_any)udf_impl::httpclient_request_async_udf, udf_impl::httpclient_int_udf_init, udf_impl::httpclient_udf_deinit)) {
+    // failed to register udf
+    delete my_udf_manager;
+    return 1;
+  }
+
+  if (!my_udf_manager->register_function("http_response", Item_result::STRING_RESULT, (Udf_func_any)udf_impl::httpclient_response_udf, udf_impl::httpclient_response_udf_init, udf_impl::httpclient_udf_deinit)) {
+    // failed to register udf
+    delete my_udf_manager;
+    return 1;
+  }
+
+  if (!my_udf_manager->register_function("http_response_status", Item_result::INT_RESULT, (Udf_func_any)udf_impl::httpclient_response_status_udf, udf_impl::httpclient_response_status_udf_init, udf_impl::httpclient_udf_deinit)) {
+    // failed to register udf
+    delete my_udf_manager;
+    return 1;
+  }
+
   return result;
 }
 
@@ -511,6 +5674,11 @@ static mysql_service_status_t httpclient_service_init() {
 static mysql_service_status_t httpclient_service_deinit() {
   mysql_service_status_t deinit_result = 0;
 
+  // stop opening connections before system variables and the pool go away
+  udf_impl::my_startup_preconnector->stop();
+  delete udf_impl::my_startup_preconnector;
+  udf_impl::my_startup_preconnector = nullptr;
+
   // unregister custom status variables
   if (mysql_service_status_variable_registration->unregister_variable((SHOW_VAR *)&httpclient_status_variables)) {
     LogComponentErr(ERROR_LEVEL, ER_LOG_PRINTF_MSG, "failed to unregister status variable(s)");
@@ -519,6 +5687,19 @@ static mysql_service_status_t httpclient_service_deinit() {
     LogComponentErr(INFORMATION_LEVEL, ER_LOG_PRINTF_MSG, "status variable(s) unregistered");
   }
 
+  // remove performance_schema table before the history it reads is deleted
+  if (unregister_request_history_table()) {
+    LogComponentErr(ERROR_LEVEL, ER_LOG_PRINTF_MSG, "failed to unregister performance_schema table");
+  }
+
+  // unregister custom system variables
+  if (unregister_system_variables()) {
+    LogComponentErr(ERROR_LEVEL, ER_LOG_PRINTF_MSG, "failed to unregister system variable(s)");
+  }
+  else {
+    LogComponentErr(INFORMATION_LEVEL, ER_LOG_PRINTF_MSG, "system variable(s) unregistered");
+  }
+
   // unregister custom privileges
   if (mysql_service_dynamic_privilege_register->unregister_privilege(HTTPCLIENT_PRIVILEGE_NAME, strlen(HTTPCLIENT_PRIVILEGE_NAME))) {
     LogComponentErr(ERROR_LEVEL, ER_LOG_PRINTF_MSG, "failed to unregister privilege 'HTTP_CLIENT'");
@@ -536,6 +5717,35 @@ static mysql_service_status_t httpclient_service_deinit() {
 
   delete my_udf_manager;
 
+  // finish background requests while their pooled handles can still be released
+  delete udf_impl::my_background_dispatcher;
+  udf_impl::my_background_dispatcher = nullptr;
+  delete udf_impl::my_transport_dispatcher;
+  udf_impl::my_transport_dispatcher = nullptr;
+  delete my_async_response_store;
+  my_async_response_store = nullptr;
+  delete my_response_cache;
+  my_response_cache = nullptr;
+  delete my_request_coalescer;
+  my_request_coalescer = nullptr;
+  delete my_request_history;
+  my_request_history = nullptr;
+  delete my_host_registry;
+  my_host_registry = nullptr;
+
+  // profiles own connection pools, so they go before curl cleanup
+  delete udf_impl::my_profile_registry;
+  udf_impl::my_profile_registry = nullptr;
+
+  // write remaining request logs
+  delete my_request_logger;
+  my_request_logger = nullptr;
+
+  // close pooled connections before curl itself is cleaned up
+  delete my_curl_handle_pool;
+  my_curl_handle_pool = nullptr;
+  curl_global_cleanup();
+
   LogComponentErr(INFORMATION_LEVEL, ER_LOG_PRINTF_MSG, "component is now fully uninstalled");
 
   return deinit_result;
@@ -552,11 +5762,21 @@ BEGIN_COMPONENT_REQUIRES(httpclient_service)
   REQUIRES_SERVICE(dynamic_privilege_register),
   REQUIRES_SERVICE(mysql_udf_metadata),
   REQUIRES_SERVICE(udf_registration),
+  REQUIRES_SERVICE(udf_registration_aggregate),
   REQUIRES_SERVICE(mysql_thd_security_context),
   REQUIRES_SERVICE(global_grants_check),
   REQUIRES_SERVICE(mysql_current_thread_reader),
   REQUIRES_SERVICE(mysql_runtime_error),
   REQUIRES_SERVICE(status_variable_registration),
+  REQUIRES_SERVICE(component_sys_variable_register),
+  REQUIRES_SERVICE(component_sys_variable_unregister),
+  REQUIRES_SERVICE(mysql_thd_attributes),
+  REQUIRES_SERVICE(pfs_plugin_table_v1),
+  REQUIRES_SERVICE(pfs_plugin_column_bigint_v1),
+  REQUIRES_SERVICE(pfs_plugin_column_integer_v1),
+  REQUIRES_SERVICE(pfs_plugin_column_string_v2),
+  REQUIRES_SERVICE(pfs_plugin_column_timestamp_v2),
+  REQUIRES_SERVICE(pfs_plugin_column_enum_v1),
 END_COMPONENT_REQUIRES();
 
 // declare component metadata
@@ -3,6 +3,8 @@
 
 // include component services neccessary for this plugin
 #include <mysqld_error.h>
+#include <mysql_com.h>
+#include <typelib.h>
 #include <mysql/components/component_implementation.h>
 #include <mysql/components/services/log_builtins.h>
 #include <mysql/components/services/dynamic_privilege.h>
@@ -13,9 +15,14 @@
 #include <mysql/components/services/mysql_thd_store_service.h>
 #include <mysql/components/services/mysql_runtime_error_service.h>
 #include <mysql/components/services/component_status_var_service.h>
+#include <mysql/components/services/component_sys_var_service.h>
+#include <mysql/components/services/mysql_thd_attributes.h>
+#include <mysql/components/services/pfs_plugin_table_service.h>
 
 #include <list>
+#include <iterator>
 #include <string>
+#include <string_view>
 #include <iostream>
 #include <sstream>
 #include <chrono>
@@ -25,22 +32,56 @@
 #include <map>
 #include <tuple>
 #include <utility>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <condition_variable>
+#include <unordered_map>
+#include <deque>
+#include <climits>
+#include <array>
+#include <cstdint>
+#include <cerrno>
+#include <cstdlib>
+#include <strings.h>
+#include <random>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
 
 // include 3rd party headers for this plugin
 #include <curl/curl.h>
+#include <zlib.h>
+#include <zstd.h>
 #include <nlohmann/json.hpp>
 
+// session state of "thd_status" thread attribute, missing in headers of older servers
+#ifndef STATUS_SESSION_OK
+#define STATUS_SESSION_OK 0
+#endif
+
 // declare which services are required for this component
 extern REQUIRES_SERVICE_PLACEHOLDER(log_builtins);
 extern REQUIRES_SERVICE_PLACEHOLDER(log_builtins_string);
 extern REQUIRES_SERVICE_PLACEHOLDER(dynamic_privilege_register);
 extern REQUIRES_SERVICE_PLACEHOLDER(udf_registration);
+extern REQUIRES_SERVICE_PLACEHOLDER(udf_registration_aggregate);
 extern REQUIRES_SERVICE_PLACEHOLDER(mysql_udf_metadata);
 extern REQUIRES_SERVICE_PLACEHOLDER(mysql_thd_security_context);
 extern REQUIRES_SERVICE_PLACEHOLDER(global_grants_check);
 extern REQUIRES_SERVICE_PLACEHOLDER(mysql_current_thread_reader);
 extern REQUIRES_SERVICE_PLACEHOLDER(mysql_runtime_error);
 extern REQUIRES_SERVICE_PLACEHOLDER(status_variable_registration);
+extern REQUIRES_SERVICE_PLACEHOLDER(component_sys_variable_register);
+extern REQUIRES_SERVICE_PLACEHOLDER(component_sys_variable_unregister);
+extern REQUIRES_SERVICE_PLACEHOLDER(mysql_thd_attributes);
+extern REQUIRES_SERVICE_PLACEHOLDER(pfs_plugin_table_v1);
+extern REQUIRES_SERVICE_PLACEHOLDER(pfs_plugin_column_bigint_v1);
+extern REQUIRES_SERVICE_PLACEHOLDER(pfs_plugin_column_integer_v1);
+extern REQUIRES_SERVICE_PLACEHOLDER(pfs_plugin_column_string_v2);
+extern REQUIRES_SERVICE_PLACEHOLDER(pfs_plugin_column_timestamp_v2);
+extern REQUIRES_SERVICE_PLACEHOLDER(pfs_plugin_column_enum_v1);
 
 extern SERVICE_TYPE(log_builtins) * log_bi;
 extern SERVICE_TYPE(log_builtins_string) * log_bs;
\ No newline at end of file